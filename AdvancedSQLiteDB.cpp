@@ -65,6 +65,7 @@ bool AdvancedSQLiteDB::initialize() {
             big_food_eaten INTEGER,
             game_duration INTEGER,
             game_status TEXT DEFAULT 'COMPLETED',
+            game_seed TEXT,
             FOREIGN KEY(player_id) REFERENCES players(player_id) ON DELETE CASCADE
         );
         
@@ -110,6 +111,9 @@ bool AdvancedSQLiteDB::initialize() {
         return false;
     }
 
+    // ɰ汾ݿûgame_seedУϣиʱԼ
+    sqlite3_exec(db, "ALTER TABLE game_records ADD COLUMN game_seed TEXT;", nullptr, nullptr, nullptr);
+
     // 
     const char* indexSql = R"(
         CREATE INDEX IF NOT EXISTS idx_players_username ON players(username);
@@ -243,8 +247,29 @@ bool AdvancedSQLiteDB::createPlayer(const std::string& username, int& playerId)
     return true;
 }
 
-int AdvancedSQLiteDB::startGame(int playerId) {
-    std::string sql = "INSERT INTO game_records (player_id, start_time) VALUES (?, CURRENT_TIMESTAMP);";
+bool AdvancedSQLiteDB::findPlayer(const std::string& username, int& playerId) {
+    std::string sql = "SELECT player_id FROM players WHERE username = ?;";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "׼SQLʧ: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_STATIC);
+
+    bool found = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        playerId = sqlite3_column_int(stmt, 0);
+        found = true;
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+int AdvancedSQLiteDB::startGame(int playerId, uint64_t seed) {
+    // 64λ޷SQLiteķΧʮı
+    std::string sql = "INSERT INTO game_records (player_id, start_time, game_seed) VALUES (?, CURRENT_TIMESTAMP, ?);";
     sqlite3_stmt* stmt;
 
     if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
@@ -253,6 +278,8 @@ int AdvancedSQLiteDB::startGame(int playerId) {
     }
 
     sqlite3_bind_int(stmt, 1, playerId);
+    const std::string seedText = std::to_string(seed);
+    sqlite3_bind_text(stmt, 2, seedText.c_str(), -1, SQLITE_TRANSIENT);
 
     if (sqlite3_step(stmt) != SQLITE_DONE) {
         std::cerr << "ִSQLʧ: " << sqlite3_errmsg(db) << std::endl;
@@ -330,6 +357,42 @@ bool AdvancedSQLiteDB::addFoodRecord(int recordId, const std::string& foodType,
     return success;
 }
 
+bool AdvancedSQLiteDB::insertGameRecords(int playerId, const std::vector<GameRecordRow>& rows) {
+    // дʱύ̫һֻ׼һ
+    std::string sql = R"(
+        INSERT INTO game_records (player_id, start_time, end_time, score, snake_length,
+                                  food_eaten, big_food_eaten, game_duration, game_status)
+        VALUES (?, CURRENT_TIMESTAMP, CURRENT_TIMESTAMP, ?, ?, ?, ?, ?, ?);
+    )";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "׼SQLʧ: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+
+    sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
+    bool success = true;
+    for (const GameRecordRow& row : rows) {
+        sqlite3_bind_int(stmt, 1, playerId);
+        sqlite3_bind_int(stmt, 2, row.score);
+        sqlite3_bind_int(stmt, 3, row.length);
+        sqlite3_bind_int(stmt, 4, row.food);
+        sqlite3_bind_int(stmt, 5, row.bigFood);
+        sqlite3_bind_int(stmt, 6, row.duration);
+        sqlite3_bind_text(stmt, 7, row.status, -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            std::cerr << "дϷ¼ʧ: " << sqlite3_errmsg(db) << std::endl;
+            success = false;
+            break;
+        }
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_exec(db, success ? "COMMIT;" : "ROLLBACK;", nullptr, nullptr, nullptr);
+    return success;
+}
+
 void AdvancedSQLiteDB::checkAchievements(int recordId, int score) {
     // 鲢ɾ
     if (score >= 100) {
@@ -534,6 +597,53 @@ bool AdvancedSQLiteDB::setConfig(const std::string& key, const std::string& valu
     return execute(sql, { key, value });
 }
 
+// system_configеĹGameRulesֻ֮
+// ÿУ飬ȱٻ޷rulesԭеֵȫʱtrue
+bool AdvancedSQLiteDB::loadGameRules(GameRules& rules) {
+    struct RuleItem {
+        const char* key;
+        int minValue;
+        int* target;
+    };
+    int period = rules.tickPeriod;
+    const RuleItem items[] = {
+        { "GAME_SPEED", 1, &period },
+        { "INITIAL_LENGTH", 1, &rules.initialLength },
+        { "MAX_LENGTH", 0, &rules.maxLength },
+        { "BIG_FOOD_SPAWN", 0, &rules.bigFoodEvery },
+        { "BIG_FOOD_SCORE", 0, &rules.foodScore[FOOD_BIG] },
+    };
+
+    bool complete = true;
+    for (const RuleItem& item : items) {
+        std::string value;
+        if (!getConfig(item.key, value)) {
+            complete = false;
+            continue;
+        }
+        try {
+            const int parsed = std::stoi(value);
+            if (parsed < item.minValue) {
+                std::cerr << "" << item.key << "Ч: " << value << std::endl;
+                complete = false;
+                continue;
+            }
+            *item.target = parsed;
+        }
+        catch (const std::exception&) {
+            std::cerr << "" << item.key << "Ч: " << value << std::endl;
+            complete = false;
+        }
+    }
+
+    // ֡ڱ仯ʱʱʳ֡Ҫһ
+    rules.SetTickPeriod(period);
+    if (rules.maxLength > 0 && rules.maxLength < rules.initialLength) {
+        rules.maxLength = rules.initialLength;
+    }
+    return complete;
+}
+
 bool AdvancedSQLiteDB::executeSQL(const std::string& sql) {
     char* errorMsg = nullptr;
     int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errorMsg);
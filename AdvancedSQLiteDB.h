@@ -1,10 +1,22 @@
 // AdvancedSQLiteDB.h - ݿ汾
 #pragma once
 #include "sqlite3.h"
+#include "GameRules.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <utility>
 
+//дgame_recordsһ
+struct GameRecordRow {
+    int score;
+    int length;
+    int food;
+    int bigFood;
+    int duration;       //
+    const char* status;
+};
+
 class AdvancedSQLiteDB {
 private:
     sqlite3* db;
@@ -28,11 +40,13 @@ public:
 
     // ҹ
     bool createPlayer(const std::string& username, int& playerId);
+    bool findPlayer(const std::string& username, int& playerId);
 
     // Ϸ¼
-    int startGame(int playerId);
+    int startGame(int playerId, uint64_t seed);     //seedΪֵӣ¼Ա
     bool endGame(int recordId, int score, int length, int food, int bigFood, const std::string& status = "COMPLETED");
     bool addFoodRecord(int recordId, const std::string& foodType, int scoreValue, int x, int y);
+    bool insertGameRecords(int playerId, const std::vector<GameRecordRow>& rows);  //һд
 
     // ѯ
     std::vector<std::pair<std::string, int>> getLeaderboard();
@@ -46,4 +60,5 @@ public:
     // ù
     bool getConfig(const std::string& key, std::string& value);
     bool setConfig(const std::string& key, const std::string& value);
+    bool loadGameRules(GameRules& rules);  //ȡȱٻЧԭֵ
 };
\ No newline at end of file
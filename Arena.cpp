@@ -0,0 +1,332 @@
+﻿// Arena.cpp - 多蛇竞技场的规则实现
+#include "Arena.h"
+#include <stdexcept>
+
+template <class B>
+BasicArena<B>::BasicArena(const B& board, int snakeCount, int foodCount, uint64_t seed, int maxLength, const LevelView* level,
+    const BasicTopology<B>* topology)
+    : board(board), level(level), topology(topology), index(board), snakes(snakeCount, ArenaSnake<B>(maxLength)), nextHead(snakeCount), fate(snakeCount), vacate(snakeCount),
+    spawnRng(seed, static_cast<uint64_t>(RngStream::SPAWN)), foodRng(seed, static_cast<uint64_t>(RngStream::FOOD)),
+    foodTarget(foodCount), foodCount(0), tick(0)
+{
+    if (level != nullptr && (!level->Valid() || level->Width() != board.Width() || level->Height() != board.Height()))
+        throw std::invalid_argument("关卡尺寸与竞技场不符");
+    if (topology != nullptr && (topology->GetBoard().Width() != board.Width() || topology->GetBoard().Height() != board.Height()))
+        throw std::invalid_argument("拓扑尺寸与竞技场不符");
+    for (int id = 0; id < snakeCount; id++)
+    {
+        Spawn(id);
+    }
+    while (this->foodCount < foodTarget && SpawnFood())
+    {
+    }
+}
+
+//在随机位置放下一条朝右、长度为ARENA_START_LENGTH的蛇；找不到空位时本帧放弃，下一帧再试
+template <class B>
+bool BasicArena<B>::Spawn(int id)
+{
+    ArenaSnake<B>& s = snakes[id];
+    const int w = board.Width();
+    const int h = board.Height();
+    if (w < ARENA_START_LENGTH)
+        return false;
+
+    for (int t = 0; t < ARENA_SPAWN_TRIES; t++)
+    {
+        const int gx = ARENA_START_LENGTH - 1 + static_cast<int>(spawnRng.Below(w - ARENA_START_LENGTH + 1));
+        const int gy = static_cast<int>(spawnRng.Below(h));
+        bool clear = true;
+        for (int i = 0; i < ARENA_START_LENGTH && clear; i++)
+        {
+            const Cell cell = static_cast<Cell>(board.CellAt(gx - i, gy));
+            clear = index.Get(cell) == CELL_EMPTY && !IsWall(cell);
+        }
+        if (!clear)
+            continue;
+
+        s.body.clear();
+        for (int i = 0; i < ARENA_START_LENGTH; i++)
+        {
+            const Cell cell = static_cast<Cell>(board.CellAt(gx - i, gy));
+            s.body.push_back(cell);
+            index.Set(cell, id);
+        }
+        s.dir = Direction::RIGHT;
+        s.next = Direction::RIGHT;
+        s.score = 0;
+        s.grow = 0;
+        s.alive = true;
+        return true;
+    }
+    return false;
+}
+
+//蛇死亡：从索引中抹去蛇身
+template <class B>
+void BasicArena<B>::Kill(int id)
+{
+    ArenaSnake<B>& s = snakes[id];
+    for (size_t i = 0; i < s.body.size(); i++)
+    {
+        //撞上别人时自己的新头部没有写入索引，只清除确实属于自己的格子
+        if (index.Get(s.body[i]) == id)
+            index.Set(s.body[i], CELL_EMPTY);
+    }
+    s.body.clear();
+    s.alive = false;
+}
+
+template <class B>
+bool BasicArena<B>::SpawnFood()
+{
+    for (int t = 0; t < ARENA_SPAWN_TRIES; t++)
+    {
+        const int gx = static_cast<int>(foodRng.Below(board.Width()));
+        const int gy = static_cast<int>(foodRng.Below(board.Height()));
+        const Cell cell = static_cast<Cell>(board.CellAt(gx, gy));
+        if (index.Get(cell) == CELL_EMPTY && (level == nullptr || level->CanFoodAt(gx, gy)) && (topology == nullptr || !topology->IsWall(cell)))
+        {
+            index.Set(cell, CELL_FOOD);
+            foodCount++;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class B>
+bool BasicArena<B>::SetDirection(int id, Direction dir)
+{
+    ArenaSnake<B>& s = snakes[id];
+    //与上一帧实际移动的方向比较，防止一帧内连续转向造成掉头
+    if (dir == s.next || IsReverse(s.dir, dir))
+    {
+        return false;
+    }
+    s.next = dir;
+    return true;
+}
+
+//所有蛇同时移动，分三个阶段：
+//1. Plan：计算新头部，与BasicSnake::Move相同地查拓扑表或按矩形边界计算，判断撞墙，记录是否让出尾部
+//2. Classify：只读索引，新头部落在蛇身上即死亡，落在食物上则进食；
+//   目标格若是本帧让出的尾巴（包括自己的）视为空格，与Snake::Move先删尾再判断撞到自己的规则一致
+//3. Resolve：让出尾部后，每条要移动的蛇先在索引中认领新头部所在的格子；同一格有两条以上的蛇认领时
+//   它们都死亡，谁也没有进入该格，格子恢复原样（食物留在原处）；认领完之后才只为独占目标格的蛇
+//   写入新头部、计分和增长，然后清除死亡的蛇，重生并补充食物
+//前两个阶段互不依赖写入；Resolve中哪些格子被争抢只取决于认领的集合，与处理顺序无关，
+//所以串行和并行的结果逐位相同
+template <class B>
+void BasicArena<B>::Plan(int begin, int end)
+{
+    for (int id = begin; id < end; id++)
+    {
+        ArenaSnake<B>& s = snakes[id];
+        vacate[id] = 0;
+        if (!s.alive)
+        {
+            fate[id] = FATE_IDLE;
+            continue;
+        }
+        s.dir = s.next;
+        const int64_t target = topology != nullptr ? static_cast<int64_t>(topology->Next(s.body[0], s.dir)) : StepRect(board, s.body[0], s.dir);
+        if (target < 0 || IsWall(static_cast<Cell>(target)))
+        {
+            fate[id] = FATE_DIE;
+            continue;
+        }
+        nextHead[id] = static_cast<Cell>(target);
+        fate[id] = FATE_MOVE;
+
+        if (s.grow > 0 && !s.body.full())
+            s.grow--;
+        else
+            vacate[id] = 1;
+    }
+}
+
+template <class B>
+void BasicArena<B>::Classify(int begin, int end)
+{
+    for (int id = begin; id < end; id++)
+    {
+        if (fate[id] != FATE_MOVE)
+            continue;
+        const int32_t target = index.Get(nextHead[id]);
+        if (target >= 0)
+        {
+            const ArenaSnake<B>& other = snakes[target];
+            if (!(vacate[target] && other.body.back() == nextHead[id]))
+                fate[id] = FATE_DIE;
+        }
+        else if (target == CELL_FOOD)
+        {
+            fate[id] = FATE_EAT;
+        }
+    }
+}
+
+template <class B>
+ArenaStats BasicArena<B>::Resolve()
+{
+    ArenaStats stats{};
+    const int n = static_cast<int>(snakes.size());
+
+    for (int id = 0; id < n; id++)
+    {
+        if (vacate[id])
+        {
+            ArenaSnake<B>& s = snakes[id];
+            index.Set(s.body.back(), CELL_EMPTY);
+            s.body.pop_back();
+        }
+    }
+
+    //认领：让出尾部之后，目标格中的蛇编号只可能是本帧先认领它的蛇头（撞蛇身的已在Classify中判死）
+    //争抢的格子仍记着第一个认领者的编号，后来的认领者由此也能发现争抢；是否是食物记在争抢者的结果中
+    for (int id = 0; id < n; id++)
+    {
+        if (fate[id] != FATE_MOVE && fate[id] != FATE_EAT)
+            continue;
+        const int32_t other = index.Get(nextHead[id]);
+        if (other >= 0)
+        {
+            const uint8_t clash = fate[id] == FATE_EAT ? FATE_CLASH_FOOD : FATE_CLASH;
+            fate[id] = clash;
+            fate[other] = clash;
+            continue;
+        }
+        index.Set(nextHead[id], id);
+    }
+
+    //只有独占目标格的蛇移动；争抢的格子由第一个认领者恢复为食物或空格
+    for (int id = 0; id < n; id++)
+    {
+        if (fate[id] == FATE_CLASH || fate[id] == FATE_CLASH_FOOD)
+        {
+            if (index.Get(nextHead[id]) == id)
+                index.Set(nextHead[id], fate[id] == FATE_CLASH_FOOD ? CELL_FOOD : CELL_EMPTY);
+            fate[id] = FATE_DIE;
+            continue;
+        }
+        if (fate[id] != FATE_MOVE && fate[id] != FATE_EAT)
+            continue;
+        ArenaSnake<B>& s = snakes[id];
+        s.body.push_front(nextHead[id]);
+        stats.moved++;
+        if (fate[id] == FATE_EAT)
+        {
+            s.score++;
+            s.grow++;
+            foodCount--;
+            stats.eaten++;
+        }
+    }
+
+    for (int id = 0; id < n; id++)
+    {
+        if (fate[id] == FATE_DIE)
+        {
+            Kill(id);
+            stats.deaths++;
+        }
+        if (!snakes[id].alive && Spawn(id))
+        {
+            stats.spawned++;
+        }
+    }
+
+    while (foodCount < foodTarget && SpawnFood())
+    {
+    }
+    return stats;
+}
+
+template <class B>
+ArenaStats BasicArena<B>::Step()
+{
+    tick++;
+    const int n = static_cast<int>(snakes.size());
+    Plan(0, n);
+    Classify(0, n);
+    return Resolve();
+}
+
+template <class B>
+ArenaStats BasicArena<B>::Step(ParallelFor& workers)
+{
+    tick++;
+    const int n = static_cast<int>(snakes.size());
+    workers.Run(n, [this](int begin, int end) { Plan(begin, end); });
+    workers.Run(n, [this](int begin, int end) { Classify(begin, end); });
+    return Resolve();
+}
+
+template <class B>
+int BasicArena<B>::SnakeCount() const
+{
+    return static_cast<int>(snakes.size());
+}
+
+template <class B>
+int BasicArena<B>::AliveCount() const
+{
+    int alive = 0;
+    for (const ArenaSnake<B>& s : snakes)
+    {
+        alive += s.alive ? 1 : 0;
+    }
+    return alive;
+}
+
+template <class B>
+int BasicArena<B>::FoodCount() const
+{
+    return foodCount;
+}
+
+template <class B>
+uint32_t BasicArena<B>::GetTick() const
+{
+    return tick;
+}
+
+template <class B>
+const ArenaSnake<B>& BasicArena<B>::GetSnake(int id) const
+{
+    return snakes[id];
+}
+
+template <class B>
+int32_t BasicArena<B>::At(int gx, int gy) const
+{
+    return index.Get(static_cast<Cell>(board.CellAt(gx, gy)));
+}
+
+template <class B>
+const B& BasicArena<B>::GetBoard() const
+{
+    return board;
+}
+
+template <class B>
+uint64_t BasicArena<B>::Checksum() const
+{
+    uint64_t h = RngMix(tick);
+    for (const ArenaSnake<B>& s : snakes)
+    {
+        h = RngMix(h ^ static_cast<uint64_t>(s.score) ^ (static_cast<uint64_t>(s.body.size()) << 32));
+        for (size_t i = 0; i < s.body.size(); i++)
+        {
+            h = RngMix(h + static_cast<uint64_t>(s.body[i]));
+        }
+    }
+    return h;
+}
+
+//显式实例化：竞技场通常较大，不提供TinyBoard版本
+template class BasicArena<StandardBoard>;
+template class BasicArena<LargeBoard>;
+template class BasicArena<DynamicBoard>;
+template class BasicArena<SparseBoard>;
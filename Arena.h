@@ -0,0 +1,113 @@
+﻿// Arena.h - 多蛇竞技场：同一棋盘上成百上千条蛇
+// 所有蛇共用一张格子->占用者的空间索引，碰撞只查目标格，每帧开销与蛇的数量成正比，与蛇身总长无关
+// 移动与BasicSnake相同：设置了拓扑时查它的下一格表，否则按矩形边界计算（StepRect）；
+// 蛇本身不用BasicSnake：它自带与棋盘等大的占用位图和空闲格索引，大棋盘上成千上万条蛇放不下，这里的蛇只保存蛇身
+#pragma once
+#include "SpatialIndex.h"
+#include "SnakeBody.h"
+#include "Topology.h"
+#include "GameRng.h"
+#include "ParallelFor.h"
+#include "LevelFile.h"
+#include <cstdint>
+#include <vector>
+
+constexpr int ARENA_MAX_LENGTH = 256;   //竞技场中蛇身的默认最大节数
+constexpr int ARENA_START_LENGTH = 3;   //出生时的长度
+constexpr int ARENA_SPAWN_TRIES = 32;   //随机找出生点/食物位置的试探次数
+
+//格子上的内容：非负值是占用该格的蛇的编号，空格为CELL_EMPTY（见SpatialIndex.h）
+constexpr int32_t CELL_FOOD = -2;
+
+//竞技场中的一条蛇：只有蛇身和少量状态，占用信息统一记在SpatialIndex中
+template <class B>
+struct ArenaSnake
+{
+    SnakeBody<HeapArray<typename B::Cell>> body;   //下标0为蛇头
+    Direction dir;      //上一帧移动的方向
+    Direction next;     //下一帧将要移动的方向
+    int score;
+    int grow;           //还需增长的节数
+    bool alive;
+
+    explicit ArenaSnake(size_t capacity)
+        : body(capacity), dir(Direction::RIGHT), next(Direction::RIGHT), score(0), grow(0), alive(false) {}
+};
+
+//一帧的统计
+struct ArenaStats
+{
+    int moved;      //本帧移动的蛇
+    int deaths;     //本帧死亡的蛇
+    int eaten;      //本帧被吃掉的食物
+    int spawned;    //本帧出生（含重生）的蛇
+};
+
+template <class B>
+class BasicArena
+{
+public:
+    using Cell = typename B::Cell;
+
+private:
+    //每帧中每条蛇的结果
+    enum Fate : uint8_t
+    {
+        FATE_IDLE,  //本帧不动（已死亡）
+        FATE_MOVE,
+        FATE_EAT,
+        FATE_DIE,
+        FATE_CLASH,         //与其他蛇头争抢同一个空格，Resolve中改为FATE_DIE
+        FATE_CLASH_FOOD,    //同上，争抢的是食物
+    };
+
+    B board;
+    const LevelView* level;         //关卡，墙和可生成食物的格子直接读其中的位图；nullptr为空场地
+    const BasicTopology<B>* topology;   //下一格查找表（环面、迷宫墙、传送门），nullptr时按矩形边界计算
+    SpatialIndex<B> index;
+    std::vector<ArenaSnake<B>> snakes;
+    std::vector<Cell> nextHead;     //本帧每条蛇的新头部
+    std::vector<uint8_t> fate;      //本帧每条蛇的结果
+    std::vector<uint8_t> vacate;    //本帧是否让出尾部
+    CounterRng spawnRng;
+    CounterRng foodRng;
+    int foodTarget;                 //场上保持的食物数
+    int foodCount;
+    uint32_t tick;
+
+    bool IsWall(Cell cell) const
+    {
+        return (level != nullptr && level->IsWallAt(board.Col(cell), board.Row(cell))) || (topology != nullptr && topology->IsWall(cell));
+    }
+    bool Spawn(int id);
+    void Kill(int id);
+    bool SpawnFood();
+
+    //Step的各阶段；Plan和Classify只写编号在[begin, end)内的蛇自己的数据，可分段并行
+    void Plan(int begin, int end);
+    void Classify(int begin, int end);
+    ArenaStats Resolve();
+
+public:
+    //level、topology须与棋盘尺寸相同并在竞技场使用期间有效，否则抛出std::invalid_argument
+    BasicArena(const B& board, int snakeCount, int foodCount, uint64_t seed, int maxLength = ARENA_MAX_LENGTH,
+        const LevelView* level = nullptr, const BasicTopology<B>* topology = nullptr);
+
+    bool SetDirection(int id, Direction dir);   //设置下一帧的方向，掉头或同向时返回false
+    ArenaStats Step();                          //所有蛇同时移动一格
+    ArenaStats Step(ParallelFor& workers);      //同上，前两个阶段分段并行；结果与线程数无关
+
+    int SnakeCount() const;
+    int AliveCount() const;
+    int FoodCount() const;
+    uint32_t GetTick() const;
+    const ArenaSnake<B>& GetSnake(int id) const;
+    int32_t At(int gx, int gy) const;           //格子上的内容：蛇编号、CELL_EMPTY或CELL_FOOD
+    const B& GetBoard() const;
+    uint64_t Checksum() const;                  //所有蛇的位置和分数的摘要，用于校验确定性
+};
+
+extern template class BasicArena<StandardBoard>;
+extern template class BasicArena<LargeBoard>;
+extern template class BasicArena<DynamicBoard>;
+extern template class BasicArena<SparseBoard>;
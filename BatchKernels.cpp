@@ -0,0 +1,222 @@
+﻿// BatchKernels.cpp - 向量化判定内核与运行时分派
+// 向量版本用函数级的目标属性编译，整个文件不需要-mavx2，在不支持的CPU上也不会执行到
+#include "BatchKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BATCH_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#define TARGET_SSE42
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#else
+#define BATCH_SIMD_X86 0
+#endif
+
+//标量版本：也是向量版本处理不足一组的尾部时使用的实现
+static void EqualScalar(const uint16_t* a, const uint16_t* b, int n, uint8_t* out)
+{
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = a[i] == b[i];
+    }
+}
+
+static void InBoundsScalar(const int16_t* x, const int16_t* y, int n, int width, int height, uint8_t* out)
+{
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = x[i] >= 0 && x[i] < width && y[i] >= 0 && y[i] < height;
+    }
+}
+
+static void OccupiedScalar(const uint64_t* bits, int words, const uint16_t* cells, int n, uint8_t* out)
+{
+    for (int i = 0; i < n; i++)
+    {
+        const uint64_t word = bits[static_cast<size_t>(i) * words + (cells[i] >> 6)];
+        out[i] = (word >> (cells[i] & 63)) & 1;
+    }
+}
+
+#if BATCH_SIMD_X86
+TARGET_SSE42 static void EqualSse42(const uint16_t* a, const uint16_t* b, int n, uint8_t* out)
+{
+    const __m128i one = _mm_set1_epi8(1);
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i lo = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        const __m128i hi = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 8)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(_mm_packs_epi16(lo, hi), one));
+    }
+    EqualScalar(a + i, b + i, n - i, out + i);
+}
+
+TARGET_SSE42 static void InBoundsSse42(const int16_t* x, const int16_t* y, int n, int width, int height, uint8_t* out)
+{
+    const __m128i minusOne = _mm_set1_epi16(-1);
+    const __m128i w = _mm_set1_epi16(static_cast<short>(width));
+    const __m128i h = _mm_set1_epi16(static_cast<short>(height));
+    const __m128i one = _mm_set1_epi8(1);
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i in[2];
+        for (int k = 0; k < 2; k++)
+        {
+            const __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i + k * 8));
+            const __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i + k * 8));
+            in[k] = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi16(vx, minusOne), _mm_cmpgt_epi16(w, vx)),
+                _mm_and_si128(_mm_cmpgt_epi16(vy, minusOne), _mm_cmpgt_epi16(h, vy)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(_mm_packs_epi16(in[0], in[1]), one));
+    }
+    InBoundsScalar(x + i, y + i, n - i, width, height, out + i);
+}
+
+//SSE没有gather：字下标和位移用向量算出，取字仍逐局进行
+TARGET_SSE42 static void OccupiedSse42(const uint64_t* bits, int words, const uint16_t* cells, int n, uint8_t* out)
+{
+    alignas(16) uint16_t word[8];
+    alignas(16) uint16_t shift[8];
+    const __m128i low6 = _mm_set1_epi16(63);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(word), _mm_srli_epi16(c, 6));
+        _mm_store_si128(reinterpret_cast<__m128i*>(shift), _mm_and_si128(c, low6));
+        for (int k = 0; k < 8; k++)
+        {
+            out[i + k] = (bits[static_cast<size_t>(i + k) * words + word[k]] >> shift[k]) & 1;
+        }
+    }
+    OccupiedScalar(bits + static_cast<size_t>(i) * words, words, cells + i, n - i, out + i);
+}
+
+TARGET_AVX2 static void EqualAvx2(const uint16_t* a, const uint16_t* b, int n, uint8_t* out)
+{
+    const __m128i one = _mm_set1_epi8(1);
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m256i eq = _mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        const __m128i packed = _mm_packs_epi16(_mm256_castsi256_si128(eq), _mm256_extracti128_si256(eq, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(packed, one));
+    }
+    EqualScalar(a + i, b + i, n - i, out + i);
+}
+
+TARGET_AVX2 static void InBoundsAvx2(const int16_t* x, const int16_t* y, int n, int width, int height, uint8_t* out)
+{
+    const __m256i minusOne = _mm256_set1_epi16(-1);
+    const __m256i w = _mm256_set1_epi16(static_cast<short>(width));
+    const __m256i h = _mm256_set1_epi16(static_cast<short>(height));
+    const __m128i one = _mm_set1_epi8(1);
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        const __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+        const __m256i in = _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi16(vx, minusOne), _mm256_cmpgt_epi16(w, vx)),
+            _mm256_and_si256(_mm256_cmpgt_epi16(vy, minusOne), _mm256_cmpgt_epi16(h, vy)));
+        const __m128i packed = _mm_packs_epi16(_mm256_castsi256_si128(in), _mm256_extracti128_si256(in, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(packed, one));
+    }
+    InBoundsScalar(x + i, y + i, n - i, width, height, out + i);
+}
+
+//每次处理8局：两次4路gather取出各局对应的字，再按位移取出该位
+TARGET_AVX2 static void OccupiedAvx2(const uint64_t* bits, int words, const uint16_t* cells, int n, uint8_t* out)
+{
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i stride = _mm256_set1_epi32(words);
+    const __m256i low6 = _mm256_set1_epi32(63);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256i c = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + i)));
+        const __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(lane, stride), _mm256_srli_epi32(c, 6));
+        const __m256i shift = _mm256_and_si256(c, low6);
+        const long long* base = reinterpret_cast<const long long*>(bits + static_cast<size_t>(i) * words);
+        for (int half = 0; half < 2; half++)
+        {
+            const __m128i idx = half ? _mm256_extracti128_si256(index, 1) : _mm256_castsi256_si128(index);
+            const __m128i sh = half ? _mm256_extracti128_si256(shift, 1) : _mm256_castsi256_si128(shift);
+            const __m256i w = _mm256_i32gather_epi64(base, idx, 8);
+            const __m256i bit = _mm256_slli_epi64(_mm256_srlv_epi64(w, _mm256_cvtepu32_epi64(sh)), 63);
+            const int mask = _mm256_movemask_pd(_mm256_castsi256_pd(bit));
+            for (int k = 0; k < 4; k++)
+            {
+                out[i + half * 4 + k] = (mask >> k) & 1;
+            }
+        }
+    }
+    OccupiedScalar(bits + static_cast<size_t>(i) * words, words, cells + i, n - i, out + i);
+}
+#endif
+
+static const BatchKernels SCALAR_KERNELS = { SimdLevel::SCALAR, "scalar", EqualScalar, InBoundsScalar, OccupiedScalar };
+#if BATCH_SIMD_X86
+static const BatchKernels SSE42_KERNELS = { SimdLevel::SSE42, "sse4.2", EqualSse42, InBoundsSse42, OccupiedSse42 };
+static const BatchKernels AVX2_KERNELS = { SimdLevel::AVX2, "avx2", EqualAvx2, InBoundsAvx2, OccupiedAvx2 };
+#endif
+
+SimdLevel DetectSimdLevel()
+{
+#if BATCH_SIMD_X86
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse42 = (info[2] >> 20) & 1;
+    const bool osxsave = (info[2] >> 27) & 1;
+    const bool avx = (info[2] >> 28) & 1;
+    bool avx2 = false;
+    //还要确认操作系统保存YMM寄存器
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] >> 5) & 1;
+    }
+#else
+    __builtin_cpu_init();
+    const bool sse42 = __builtin_cpu_supports("sse4.2");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2)
+        return SimdLevel::AVX2;
+    if (sse42)
+        return SimdLevel::SSE42;
+#endif
+    return SimdLevel::SCALAR;
+}
+
+const BatchKernels& GetBatchKernels(SimdLevel level)
+{
+#if BATCH_SIMD_X86
+    const SimdLevel best = DetectSimdLevel();
+    if (level == SimdLevel::AVX2 && best == SimdLevel::AVX2)
+        return AVX2_KERNELS;
+    if (level != SimdLevel::SCALAR && best != SimdLevel::SCALAR)
+        return SSE42_KERNELS;
+#endif
+    (void)level;
+    return SCALAR_KERNELS;
+}
+
+const BatchKernels& ActiveBatchKernels()
+{
+    static const BatchKernels& active = GetBatchKernels(DetectSimdLevel());
+    return active;
+}
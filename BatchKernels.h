@@ -0,0 +1,32 @@
+﻿// BatchKernels.h - 批量模拟器的向量化判定内核
+// 对连续数组中的多局游戏同时做三种判定：蛇头是否吃到食物、新头部是否出界、新头部是否撞到蛇身
+// 提供AVX2（一条指令16局）、SSE4.2（8局）和标量三个版本，运行时按CPU支持的指令集选择
+#pragma once
+#include <cstdint>
+
+enum class SimdLevel
+{
+    SCALAR,
+    SSE42,
+    AVX2,
+};
+
+//各判定的输出都是每局一个字节：1表示成立，0表示不成立
+struct BatchKernels
+{
+    SimdLevel level;
+    const char* name;
+
+    //out[i] = a[i] == b[i]，用于蛇头格子与食物格子的比较
+    void (*equal)(const uint16_t* a, const uint16_t* b, int n, uint8_t* out);
+
+    //out[i] = 0 <= x[i] < width && 0 <= y[i] < height
+    void (*inBounds)(const int16_t* x, const int16_t* y, int n, int width, int height, uint8_t* out);
+
+    //out[i] = 第i局位图（从bits + i * words开始）中cells[i]位是否为1
+    void (*occupied)(const uint64_t* bits, int words, const uint16_t* cells, int n, uint8_t* out);
+};
+
+SimdLevel DetectSimdLevel();                    //当前CPU支持的最高级别
+const BatchKernels& GetBatchKernels(SimdLevel level);   //不支持的级别会退回到可用的最高级别
+const BatchKernels& ActiveBatchKernels();       //按DetectSimdLevel选择，首次调用时确定
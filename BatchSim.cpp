@@ -0,0 +1,396 @@
+﻿// BatchSim.cpp - 批量模拟器实现
+#include "BatchSim.h"
+#include "Bitboard.h"
+#include "Topology.h"
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+
+//每局的状态位
+enum BatchFlags : uint8_t
+{
+    BATCH_HAS_FOOD = 1u << 0,
+    BATCH_HAS_BIGFOOD = 1u << 1,
+    BATCH_BIGFOOD_ACTIVE = 1u << 2,
+    BATCH_GROW = 1u << 3,
+    BATCH_DEAD = 1u << 4,       //上一次移动出界或撞到自己
+};
+
+constexpr int WORDS = StandardBoard::WORDS;
+
+static_assert(std::is_same<CellIndex, uint16_t>::value, "向量内核按16位格子编号比较");
+
+BatchSim::BatchSim(int games, uint64_t seed, int capacity, const GameRules& rules)
+    : games(games), capacity(capacity < 3 ? 3 : capacity), seed(seed), rules(rules), kernels(&ActiveBatchKernels()),
+    policy(BatchPolicy::RANDOM),
+    head(games), headCell(games), length(games), dir(games), flags(games), score(games), count(games),
+    food(games), bigFood(games), bigFoodTick(games), tick(games), round(games, 0),
+    foodRng(games), botRng(games),
+    body(static_cast<size_t>(games) * this->capacity), occupied(static_cast<size_t>(games) * WORDS),
+    finished(games, 0), finishedScore(games, 0), ticks(games, 0)
+{
+    //与Snake::Reset相同的截断：最大长度不超过容量，开局长度不超过最大长度和棋盘宽度
+    if (this->rules.maxLength <= 0 || this->rules.maxLength > this->capacity)
+        this->rules.maxLength = this->capacity;
+    this->rules.initialLength = std::max(1, std::min({ this->rules.initialLength, this->rules.maxLength, GRID_WIDTH }));
+    for (int g = 0; g < games; g++)
+    {
+        Reset(g);
+    }
+}
+
+//第g个槽位开始新的一局，种子由批次种子、槽位和局数决定
+void BatchSim::Reset(int g)
+{
+    const uint64_t gameSeed = RngMix(seed ^ RngMix((static_cast<uint64_t>(g) << 32) | round[g]++));
+    foodRng[g].Seed(gameSeed, static_cast<uint64_t>(RngStream::FOOD));
+    botRng[g].Seed(gameSeed, static_cast<uint64_t>(RngStream::EFFECT));
+
+    uint64_t* occ = &occupied[static_cast<size_t>(g) * WORDS];
+    for (int w = 0; w < WORDS; w++)
+    {
+        occ[w] = 0;
+    }
+    //与Snake::Reset相同：第3行第0~initialLength-1列，朝右
+    CellIndex* seg = &body[static_cast<size_t>(g) * capacity];
+    const int start = rules.initialLength;
+    head[g] = 0;
+    length[g] = static_cast<uint16_t>(start);
+    for (int i = 0; i < start; i++)
+    {
+        const int cell = StandardBoard::CellAt(start - 1 - i, 3);
+        seg[i] = static_cast<CellIndex>(cell);
+        occ[cell >> 6] |= uint64_t(1) << (cell & 63);
+    }
+    headCell[g] = seg[0];
+    dir[g] = static_cast<uint8_t>(Direction::RIGHT);
+    flags[g] = 0;
+    score[g] = 0;
+    count[g] = 0;
+    tick[g] = 0;
+    SpawnFood(g);
+}
+
+//第k个（从0数）不被蛇身占据、也不是skipA/skipB的格子，不存在时返回-1；按格子编号排序，与BasicBitboard::Select相同
+int BatchSim::SelectFree(int g, int k, int skipA, int skipB) const
+{
+    const uint64_t* occ = &occupied[static_cast<size_t>(g) * WORDS];
+    return SelectWords(WORDS, k, [occ, skipA, skipB](int w)
+    {
+        //最后一个字只有前GRID_CELLS % 64位是格子
+        uint64_t freeBits = ~occ[w] & ((w == WORDS - 1) ? ~uint64_t(0) >> ((64 - GRID_CELLS % 64) % 64) : ~uint64_t(0));
+        if (skipA >= 0 && skipA >> 6 == w)
+            freeBits &= ~(uint64_t(1) << (skipA & 63));
+        if (skipB >= 0 && skipB >> 6 == w)
+            freeBits &= ~(uint64_t(1) << (skipB & 63));
+        return freeBits;
+    });
+}
+
+//在空闲格中均匀抽取，与FoodPool::Spawn相同：抽到另一个食物所在的格子时重抽，
+//重抽FOOD_SPAWN_TRIES次仍失败时在既不是蛇身也没有食物的格子中抽取
+int BatchSim::PickFree(int g, CounterRng& rng) const
+{
+    const int freeCount = GRID_CELLS - length[g];
+    if (freeCount <= 0)
+        return -1;
+    //蛇头可能正停在还没结算的食物上，这样的格子本来就不在空闲格中，不用再排除
+    const uint64_t* occ = &occupied[static_cast<size_t>(g) * WORDS];
+    const auto freeFood = [occ](bool has, int cell) { return has && !((occ[cell >> 6] >> (cell & 63)) & 1) ? cell : -1; };
+    const int foodCell = freeFood((flags[g] & BATCH_HAS_FOOD) != 0, food[g]);
+    const int bigCell = freeFood((flags[g] & BATCH_HAS_BIGFOOD) != 0, bigFood[g]);
+    for (int t = 0; t < FOOD_SPAWN_TRIES; t++)
+    {
+        const int cell = SelectFree(g, static_cast<int>(rng.Below(static_cast<uint32_t>(freeCount))), -1, -1);
+        if (cell != foodCell && cell != bigCell)
+            return cell;
+    }
+    const int available = freeCount - (foodCell >= 0 ? 1 : 0) - (bigCell >= 0 ? 1 : 0);
+    if (available <= 0)
+        return -1;
+    return SelectFree(g, static_cast<int>(rng.Below(static_cast<uint32_t>(available))), foodCell, bigCell);
+}
+
+void BatchSim::SpawnFood(int g)
+{
+    if (flags[g] & (BATCH_HAS_FOOD | BATCH_HAS_BIGFOOD))
+        return;
+    const int cell = PickFree(g, foodRng[g]);
+    if (cell >= 0)
+    {
+        food[g] = static_cast<CellIndex>(cell);
+        flags[g] |= BATCH_HAS_FOOD;
+    }
+}
+
+//与GameCore::CheckBigFood相同
+void BatchSim::CheckBigFood(int g)
+{
+    const int every = rules.bigFoodEvery;
+    if (every > 0 && count[g] % every == 0 && count[g] > 0 && !(flags[g] & (BATCH_BIGFOOD_ACTIVE | BATCH_HAS_BIGFOOD)))
+    {
+        const int cell = PickFree(g, foodRng[g]);
+        if (cell >= 0)
+        {
+            bigFood[g] = static_cast<CellIndex>(cell);
+            bigFoodTick[g] = tick[g];
+            flags[g] |= BATCH_HAS_BIGFOOD | BATCH_BIGFOOD_ACTIVE;
+        }
+    }
+
+    if ((flags[g] & BATCH_HAS_BIGFOOD) && tick[g] - bigFoodTick[g] > static_cast<uint32_t>(rules.foodLifetime[FOOD_BIG]))
+    {
+        flags[g] &= ~(BATCH_HAS_BIGFOOD | BATCH_BIGFOOD_ACTIVE);
+        count[g] = 0;
+        SpawnFood(g);
+    }
+}
+
+//与GameFarm的BotDirection相同：在不掉头的三个方向中选一个不出界、不撞蛇身且离分值最高的食物最近的，都走不通时保持原方向
+Direction BatchSim::BotDirection(int g) const
+{
+    const int head = headCell[g];
+    int target = head;
+    int bestValue = 0;
+    if ((flags[g] & BATCH_HAS_FOOD) && rules.foodScore[FOOD_NORMAL] > bestValue)
+    {
+        target = food[g];
+        bestValue = rules.foodScore[FOOD_NORMAL];
+    }
+    if ((flags[g] & BATCH_HAS_BIGFOOD) && rules.foodScore[FOOD_BIG] > bestValue)
+        target = bigFood[g];
+    const int tx = StandardBoard::Col(target);
+    const int ty = StandardBoard::Row(target);
+
+    const uint64_t* occ = &occupied[static_cast<size_t>(g) * WORDS];
+    const Direction current = static_cast<Direction>(dir[g]);
+    Direction best = current;
+    int bestDistance = -1;
+    //按UP、DOWN、RIGHT、LEFT的顺序比较，距离相同时取先出现的，与GameFarm的BOT_DIRECTIONS相同
+    for (int d = 0; d < 4; d++)
+    {
+        const Direction want = static_cast<Direction>(d);
+        if (IsReverse(current, want))
+            continue;
+        const int64_t next = StepRect(StandardBoard(), static_cast<CellIndex>(head), want);
+        if (next == TOPOLOGY_WALL || ((occ[next >> 6] >> (next & 63)) & 1))
+            continue;
+        const int cell = static_cast<int>(next);
+        const int distance = std::abs(StandardBoard::Col(cell) - tx) + std::abs(StandardBoard::Row(cell) - ty);
+        if (bestDistance < 0 || distance < bestDistance)
+        {
+            best = want;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+//一帧的开始：结算上一帧判负的局并重开，然后转向、检查大食物（与GameCore::Step的顺序相同）
+void BatchSim::BeginTick(int g, int turnPercent)
+{
+    if (flags[g] & BATCH_DEAD)
+    {
+        finished[g]++;
+        finishedScore[g] += score[g];
+        Reset(g);
+    }
+
+    tick[g]++;
+    ticks[g]++;
+    CounterRng& bot = botRng[g];
+    if (policy == BatchPolicy::BOT)
+    {
+        dir[g] = static_cast<uint8_t>(BotDirection(g));
+    }
+    else if (static_cast<int>(bot.Below(100)) < turnPercent)
+    {
+        //随机转向，掉头或同向视为无效，与Snake::SetDirection一致
+        const Direction want = static_cast<Direction>(bot.Below(4));
+        if (!IsReverse(static_cast<Direction>(dir[g]), want))
+            dir[g] = static_cast<uint8_t>(want);
+    }
+
+    CheckBigFood(g);
+}
+
+//eatFood/eatBig只比较了格子，这里再结合本局是否有该食物
+void BatchSim::ApplyEat(int g, bool eatFood, bool eatBig)
+{
+    if ((flags[g] & BATCH_HAS_FOOD) && eatFood)
+    {
+        score[g] += rules.foodScore[FOOD_NORMAL];
+        count[g]++;
+        flags[g] = (flags[g] & ~BATCH_HAS_FOOD) | BATCH_GROW;
+        CheckBigFood(g);
+        if (!(flags[g] & BATCH_HAS_BIGFOOD))
+            SpawnFood(g);
+    }
+    else if ((flags[g] & BATCH_HAS_BIGFOOD) && eatBig)
+    {
+        score[g] += rules.foodScore[FOOD_BIG];
+        count[g]++;
+        flags[g] = (flags[g] & ~(BATCH_HAS_BIGFOOD | BATCH_BIGFOOD_ACTIVE)) | BATCH_GROW;
+        SpawnFood(g);
+    }
+}
+
+//推进[begin, begin + n)这一块：标量部分逐局处理，三种判定交给向量内核整块计算
+//移动规则与Snake::Move相同：出界时不动；先删尾再检查新头部是否撞到自己
+void BatchSim::StepBlock(int begin, int n, int turnPercent)
+{
+    uint8_t eatFood[BATCH_BLOCK];
+    uint8_t eatBig[BATCH_BLOCK];
+    uint8_t inside[BATCH_BLOCK];
+    uint8_t hit[BATCH_BLOCK];
+    int16_t nextX[BATCH_BLOCK];
+    int16_t nextY[BATCH_BLOCK];
+    uint16_t next[BATCH_BLOCK];
+
+    for (int i = 0; i < n; i++)
+    {
+        BeginTick(begin + i, turnPercent);
+    }
+
+    //大食物可能在BeginTick中出现或消失，所以在它之后比较
+    kernels->equal(&headCell[begin], &food[begin], n, eatFood);
+    kernels->equal(&headCell[begin], &bigFood[begin], n, eatBig);
+
+    for (int i = 0; i < n; i++)
+    {
+        const int g = begin + i;
+        ApplyEat(g, eatFood[i] != 0, eatBig[i] != 0);
+
+        //与StepRect相同的位移，出界由下面的向量内核判定
+        const int d = dir[g];
+        const int gx = StandardBoard::Col(headCell[g]) + TOPOLOGY_DX[d];
+        const int gy = StandardBoard::Row(headCell[g]) + TOPOLOGY_DY[d];
+        nextX[i] = static_cast<int16_t>(gx);
+        nextY[i] = static_cast<int16_t>(gy);
+    }
+
+    kernels->inBounds(nextX, nextY, n, GRID_WIDTH, GRID_HEIGHT, inside);
+
+    for (int i = 0; i < n; i++)
+    {
+        const int g = begin + i;
+        if (!inside[i])
+        {
+            flags[g] |= BATCH_DEAD;
+            next[i] = 0;    //不使用，只保证下面的判定不越界
+            continue;
+        }
+        next[i] = static_cast<uint16_t>(StandardBoard::CellAt(nextX[i], nextY[i]));
+        if (!(flags[g] & BATCH_GROW) || length[g] >= rules.maxLength)
+        {
+            const CellIndex* seg = &body[static_cast<size_t>(g) * capacity];
+            int tailSlot = head[g] + length[g] - 1;
+            if (tailSlot >= capacity)
+                tailSlot -= capacity;
+            const int tailCell = seg[tailSlot];
+            occupied[static_cast<size_t>(g) * WORDS + (tailCell >> 6)] &= ~(uint64_t(1) << (tailCell & 63));
+            length[g]--;
+        }
+        flags[g] &= ~BATCH_GROW;
+    }
+
+    kernels->occupied(&occupied[static_cast<size_t>(begin) * WORDS], WORDS, next, n, hit);
+
+    for (int i = 0; i < n; i++)
+    {
+        const int g = begin + i;
+        if (!inside[i])
+            continue;
+        CellIndex* seg = &body[static_cast<size_t>(g) * capacity];
+        head[g] = static_cast<uint16_t>(head[g] == 0 ? capacity - 1 : head[g] - 1);
+        seg[head[g]] = next[i];
+        headCell[g] = next[i];
+        length[g]++;
+        occupied[static_cast<size_t>(g) * WORDS + (next[i] >> 6)] |= uint64_t(1) << (next[i] & 63);
+        if (hit[i])
+            flags[g] |= BATCH_DEAD;
+    }
+}
+
+void BatchSim::StepRange(int begin, int end, int turnPercent)
+{
+    for (int g = begin; g < end; g += BATCH_BLOCK)
+    {
+        StepBlock(g, end - g < BATCH_BLOCK ? end - g : BATCH_BLOCK, turnPercent);
+    }
+}
+
+void BatchSim::Step(int turnPercent)
+{
+    StepRange(0, games, turnPercent);
+}
+
+//各局互不相关，分段并行的结果与串行相同
+void BatchSim::Step(ParallelFor& workers, int turnPercent)
+{
+    workers.Run(games, [this, turnPercent](int begin, int end) { StepRange(begin, end, turnPercent); });
+}
+
+int BatchSim::Games() const
+{
+    return games;
+}
+
+void BatchSim::UsePolicy(BatchPolicy policy)
+{
+    this->policy = policy;
+}
+
+void BatchSim::UseKernels(SimdLevel level)
+{
+    kernels = &GetBatchKernels(level);
+}
+
+const BatchKernels& BatchSim::Kernels() const
+{
+    return *kernels;
+}
+
+BatchStats BatchSim::Stats() const
+{
+    BatchStats stats{};
+    for (int g = 0; g < games; g++)
+    {
+        stats.finished += finished[g];
+        stats.totalScore += finishedScore[g];
+        stats.ticks += static_cast<long long>(ticks[g]);
+    }
+    return stats;
+}
+
+int BatchSim::GetScore(int g) const
+{
+    return score[g];
+}
+
+int BatchSim::GetLength(int g) const
+{
+    return length[g];
+}
+
+int BatchSim::GetHeadCell(int g) const
+{
+    return headCell[g];
+}
+
+Direction BatchSim::GetDirection(int g) const
+{
+    return static_cast<Direction>(dir[g]);
+}
+
+int BatchSim::GetFoodCell(int g, uint8_t kind) const
+{
+    if (kind == FOOD_BIG)
+        return (flags[g] & BATCH_HAS_BIGFOOD) ? bigFood[g] : -1;
+    return (flags[g] & BATCH_HAS_FOOD) ? food[g] : -1;
+}
+
+bool BatchSim::Died(int g) const
+{
+    return (flags[g] & BATCH_DEAD) != 0;
+}
@@ -0,0 +1,94 @@
+﻿// BatchSim.h - 结构数组布局的批量模拟器：N局单人游戏同步推进
+// 用于大批量蒙特卡洛调参。每个字段是一个连续数组，第g局的数据在各数组的第g项（蛇身和位图是第g段），
+// 规则与GameCore::Step一致（标准52x32棋盘），但不创建任何Snake/Food对象；tests/BatchSimTest逐帧与GameCore对照
+#pragma once
+#include "Board.h"
+#include "GameRules.h"
+#include "GameRng.h"
+#include "ParallelFor.h"
+#include "BatchKernels.h"
+#include <cstdint>
+#include <vector>
+
+constexpr int BATCH_MAX_LENGTH = 128;   //每局蛇身的默认容量，达到后不再增长
+constexpr int BATCH_BLOCK = 1024;       //每次按块推进的局数，块内各阶段的临时数组放在栈上
+
+//每局的转向策略
+enum class BatchPolicy
+{
+    RANDOM,     //按turnPercent%的概率随机转向
+    BOT,        //与GameFarm的BOT相同的贪心策略：朝分值最高的食物走，避开边界和蛇身
+};
+
+//批量统计
+struct BatchStats
+{
+    long long finished;     //已结束的局数
+    long long totalScore;   //已结束各局的分数之和
+    long long ticks;        //所有局推进的逻辑帧之和
+};
+
+class BatchSim
+{
+private:
+    int games;
+    int capacity;
+    uint64_t seed;
+    GameRules rules;                    //所有局共用的规则，开局长度和最大长度已按容量截断
+    const BatchKernels* kernels;        //吃食物、出界、撞身的批量判定
+    BatchPolicy policy;
+
+    //每局一项
+    std::vector<uint16_t> head;         //蛇头在本局蛇身段中的下标
+    std::vector<CellIndex> headCell;    //蛇头所在格子，连续存放供向量内核比较
+    std::vector<uint16_t> length;
+    std::vector<uint8_t> dir;           //Direction
+    std::vector<uint8_t> flags;         //BatchFlags的组合
+    std::vector<int32_t> score;
+    std::vector<int32_t> count;         //辅助判断大食物的生成
+    std::vector<CellIndex> food;
+    std::vector<CellIndex> bigFood;
+    std::vector<uint32_t> bigFoodTick;  //大食物生成时的逻辑帧
+    std::vector<uint32_t> tick;
+    std::vector<uint32_t> round;        //本槽位已开始的局数，用于派生下一局的种子
+    std::vector<CounterRng> foodRng;
+    std::vector<CounterRng> botRng;     //RANDOM策略使用的子流
+
+    //每局一段
+    std::vector<CellIndex> body;        //games * capacity，环形缓冲区
+    std::vector<uint64_t> occupied;     //games * StandardBoard::WORDS
+
+    //每局的累计统计，Step只写自己的槽位，Stats再汇总
+    std::vector<uint32_t> finished;
+    std::vector<int64_t> finishedScore;
+    std::vector<uint64_t> ticks;
+
+    void Reset(int g);
+    void SpawnFood(int g);
+    int SelectFree(int g, int k, int skipA, int skipB) const;
+    int PickFree(int g, CounterRng& rng) const;
+    void CheckBigFood(int g);
+    Direction BotDirection(int g) const;
+    void BeginTick(int g, int turnPercent);
+    void ApplyEat(int g, bool eatFood, bool eatBig);
+    void StepBlock(int begin, int n, int turnPercent);
+    void StepRange(int begin, int end, int turnPercent);
+
+public:
+    BatchSim(int games, uint64_t seed, int capacity = BATCH_MAX_LENGTH, const GameRules& rules = GameRules());
+
+    int Games() const;
+    void UseKernels(SimdLevel level);   //默认按CPU自动选择，基准测试可指定
+    const BatchKernels& Kernels() const;
+    void UsePolicy(BatchPolicy policy); //默认RANDOM
+    //推进所有局一个逻辑帧，每局按策略转向（turnPercent只用于RANDOM），结束的局立即用新种子重开
+    void Step(int turnPercent);
+    void Step(ParallelFor& workers, int turnPercent);
+    BatchStats Stats() const;
+    int GetScore(int g) const;
+    int GetLength(int g) const;
+    int GetHeadCell(int g) const;
+    Direction GetDirection(int g) const;
+    int GetFoodCell(int g, uint8_t kind) const;     //该种类食物所在的格子，没有时为-1
+    bool Died(int g) const;                         //本帧的移动出界或撞到自己，下一帧开始时重开
+};
@@ -0,0 +1,378 @@
+﻿// Bitboard.h - 编译期尺寸棋盘的位棋盘
+// 按格子编号y*W+x逐位存放，与BasicOccupancy和关卡文件中位图的布局相同，可以直接整块拷入；标准52x32棋盘正好26个字
+// 上下左右的邻格扩展是整块移位加列掩码，按位运算和计数逐字进行，与格子数成正比而不是与蛇长或食物数成正比
+// 数组前后各留若干全零的字，任意方向的移位都只是错位读取，不必单独处理首尾；
+// 以AVX2编译（-mavx2或/arch:AVX2）时邻格扩展每条指令处理4个字，其余按字循环由编译器向量化
+// 移位不跨越棋盘边缘，不表示环面和传送门
+#pragma once
+#include "Board.h"
+#include <cstdint>
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//64位字中置位的个数
+inline int BitCount(uint64_t x)
+{
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(x));
+#elif defined(__POPCNT__)
+    return __builtin_popcountll(x);
+#else
+    //编译时未启用popcnt指令：按位并行求和，比编译器的库函数快
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<int>((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+//最低置位的下标，x不能为0
+inline int LowestBit(uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+//x中第k个（从0开始数）置位的下标，x需至少有k+1个置位
+inline int SelectBit(uint64_t x, int k)
+{
+#if defined(__BMI2__)
+    return LowestBit(_pdep_u64(uint64_t(1) << k, x));
+#else
+    for (; k > 0; k--)
+        x &= x - 1;
+    return LowestBit(x);
+#endif
+}
+
+//把word(0)..word(n-1)看作连续的位图，返回第k个置位的格子编号，不足k+1个时返回-1
+//按字计数跳过，落到的字内再用SelectBit；位棋盘和批量模拟都用它按序号取格子
+template <class F>
+int SelectWords(int n, int k, F&& word)
+{
+    for (int i = 0; i < n; i++)
+    {
+        const uint64_t w = word(i);
+        const int c = BitCount(w);
+        if (k < c)
+            return i * 64 + SelectBit(w, k);
+        k -= c;
+    }
+    return -1;
+}
+
+//B为编译期尺寸的棋盘（TinyBoard、StandardBoard、LargeBoard）
+template <class B>
+class BasicBitboard
+{
+    static_assert(B::CELLS > 0, "位棋盘只用于编译期尺寸的棋盘");
+
+public:
+    static constexpr int WIDTH = B::Width();
+    static constexpr int HEIGHT = B::Height();
+    static constexpr int CELLS = B::CELLS;
+    static constexpr int WORDS = B::WORDS;
+    static constexpr int SPAN = (WORDS + 3) / 4 * 4;            //按4个字一组处理的长度，WORDS之后的字始终为0
+    static constexpr int PAD = (WIDTH / 64 + 2 + 3) / 4 * 4;     //前后全零的字数，上下移一行时错位读取不会越界
+
+private:
+    static constexpr uint64_t LAST_MASK = CELLS % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (CELLS % 64)) - 1;
+
+    alignas(32) uint64_t data[PAD + SPAN + PAD] = {};
+
+    constexpr uint64_t* Bits() { return data + PAD; }
+    constexpr const uint64_t* Bits() const { return data + PAD; }
+
+    //第i个字整体向高位移N格（N<0时向低位），读取的都是src中i附近的字
+    template <int N>
+    static uint64_t ShiftWord(const uint64_t* src, int i)
+    {
+        constexpr int M = N < 0 ? -N : N;
+        constexpr int Q = M / 64;
+        constexpr int R = M % 64;
+        if constexpr (R == 0)
+            return N > 0 ? src[i - Q] : src[i + Q];
+        else if constexpr (N > 0)
+            return (src[i - Q] << R) | (src[i - Q - 1] >> (64 - R));
+        else
+            return (src[i + Q] >> R) | (src[i + Q + 1] << (64 - R));
+    }
+
+#if defined(__AVX2__)
+    //同上，一次4个字；AVX2中移位量不小于64时结果为0，R为0时无需单独处理
+    template <int N>
+    static __m256i ShiftVec(const uint64_t* src, int i)
+    {
+        constexpr int M = N < 0 ? -N : N;
+        constexpr int Q = M / 64;
+        constexpr int R = M % 64;
+        if constexpr (N > 0)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i - Q));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i - Q - 1));
+            return _mm256_or_si256(_mm256_slli_epi64(a, R), _mm256_srli_epi64(b, 64 - R));
+        }
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + Q));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + Q + 1));
+        return _mm256_or_si256(_mm256_srli_epi64(a, R), _mm256_slli_epi64(b, 64 - R));
+    }
+#endif
+
+    template <int N>
+    BasicBitboard Shifted() const
+    {
+        BasicBitboard out;
+        for (int i = 0; i < SPAN; i++)
+            out.Bits()[i] = ShiftWord<N>(Bits(), i);
+        out.Trim();
+        return out;
+    }
+
+    //清掉最后一个有效字中超出棋盘的位和之后的补齐字
+    void Trim()
+    {
+        Bits()[WORDS - 1] &= LAST_MASK;
+        for (int i = WORDS; i < SPAN; i++)
+            Bits()[i] = 0;
+    }
+
+public:
+    constexpr BasicBitboard() = default;
+
+    //从按同样布局存放的WORDS个字拷入，如占用位图、关卡的墙和食物位图
+    static BasicBitboard FromWords(const uint64_t* words)
+    {
+        BasicBitboard b;
+        for (int i = 0; i < WORDS; i++)
+            b.Bits()[i] = words[i];
+        b.Trim();
+        return b;
+    }
+
+    //棋盘上所有格子
+    static constexpr BasicBitboard Full()
+    {
+        BasicBitboard b;
+        b.SetRange(0, CELLS);
+        return b;
+    }
+
+    //除第skip列以外的所有格子，用作左右移位时的列掩码
+    static constexpr BasicBitboard ColumnsExcept(int skip)
+    {
+        BasicBitboard b;
+        for (int y = 0; y < HEIGHT; y++)
+        {
+            b.SetRange(y * WIDTH, y * WIDTH + skip);
+            b.SetRange(y * WIDTH + skip + 1, (y + 1) * WIDTH);
+        }
+        return b;
+    }
+
+    constexpr bool Test(int cell) const { return (Bits()[cell >> 6] >> (cell & 63)) & 1; }
+    constexpr void Set(int cell) { Bits()[cell >> 6] |= uint64_t(1) << (cell & 63); }
+    constexpr void Reset(int cell) { Bits()[cell >> 6] &= ~(uint64_t(1) << (cell & 63)); }
+
+    //置位[begin, end)中的所有格子
+    constexpr void SetRange(int begin, int end)
+    {
+        while (begin < end)
+        {
+            const int bit = begin & 63;
+            const int n = end - begin < 64 - bit ? end - begin : 64 - bit;
+            const uint64_t run = n == 64 ? ~uint64_t(0) : ((uint64_t(1) << n) - 1);
+            Bits()[begin >> 6] |= run << bit;
+            begin += n;
+        }
+    }
+
+    const uint64_t* Words() const { return Bits(); }
+
+    bool Any() const
+    {
+        uint64_t any = 0;
+        for (int i = 0; i < SPAN; i++)
+            any |= Bits()[i];
+        return any != 0;
+    }
+
+    int Count() const
+    {
+        int n = 0;
+        for (int i = 0; i < WORDS; i++)
+            n += BitCount(Bits()[i]);
+        return n;
+    }
+
+    //与mask的交集的格子数，不生成中间结果
+    int CountAnd(const BasicBitboard& mask) const
+    {
+        int n = 0;
+        for (int i = 0; i < WORDS; i++)
+            n += BitCount(Bits()[i] & mask.Bits()[i]);
+        return n;
+    }
+
+    //按格子编号从小到大第k个置位的格子（k从0开始），不足k+1个时返回-1
+    int Select(int k) const
+    {
+        return SelectWords(WORDS, k, [this](int i) { return Bits()[i]; });
+    }
+
+    BasicBitboard& operator&=(const BasicBitboard& o)
+    {
+        for (int i = 0; i < SPAN; i++)
+            Bits()[i] &= o.Bits()[i];
+        return *this;
+    }
+
+    BasicBitboard& operator|=(const BasicBitboard& o)
+    {
+        for (int i = 0; i < SPAN; i++)
+            Bits()[i] |= o.Bits()[i];
+        return *this;
+    }
+
+    BasicBitboard& operator^=(const BasicBitboard& o)
+    {
+        for (int i = 0; i < SPAN; i++)
+            Bits()[i] ^= o.Bits()[i];
+        return *this;
+    }
+
+    //用o的第[begin, end)个字替换本对象的对应部分；有字变化时返回true，first、last为变化的第一个和最后一个字
+    bool AssignRange(const BasicBitboard& o, int begin, int end, int& first, int& last)
+    {
+        //先从两头找到不同的字，中间整段拷贝，循环里没有难以预测的分支
+        first = begin;
+        while (first < end && Bits()[first] == o.Bits()[first])
+            first++;
+        if (first == end)
+            return false;
+        last = end - 1;
+        while (Bits()[last] == o.Bits()[last])
+            last--;
+        for (int i = first; i <= last; i++)
+            Bits()[i] = o.Bits()[i];
+        return true;
+    }
+
+    //去掉o中的格子
+    BasicBitboard& AndNot(const BasicBitboard& o)
+    {
+        for (int i = 0; i < SPAN; i++)
+            Bits()[i] &= ~o.Bits()[i];
+        return *this;
+    }
+
+    //按引用传参：32字节对齐的类型在部分平台上不能按值传递
+    friend BasicBitboard operator&(const BasicBitboard& a, const BasicBitboard& b) { BasicBitboard r = a; return r &= b; }
+    friend BasicBitboard operator|(const BasicBitboard& a, const BasicBitboard& b) { BasicBitboard r = a; return r |= b; }
+    friend BasicBitboard operator^(const BasicBitboard& a, const BasicBitboard& b) { BasicBitboard r = a; return r ^= b; }
+
+    //补集，只含棋盘内的格子
+    BasicBitboard operator~() const
+    {
+        BasicBitboard out;
+        for (int i = 0; i < SPAN; i++)
+            out.Bits()[i] = ~Bits()[i];
+        out.Trim();
+        return out;
+    }
+
+    bool operator==(const BasicBitboard& o) const
+    {
+        uint64_t diff = 0;
+        for (int i = 0; i < SPAN; i++)
+            diff |= Bits()[i] ^ o.Bits()[i];
+        return diff == 0;
+    }
+
+    bool operator!=(const BasicBitboard& o) const { return !(*this == o); }
+
+    //每个格子移到相邻格，出界的丢弃
+    BasicBitboard North() const { return Shifted<-WIDTH>(); }
+    BasicBitboard South() const { return Shifted<WIDTH>(); }
+    BasicBitboard East() const;
+    BasicBitboard West() const;
+    BasicBitboard Neighbors() const { return North() | South() | East() | West(); }
+
+    //dst = (src及其四邻) & mask，一次遍历完成；返回dst与src是否不同
+    //只处理第[begin, end)个字（都是4的倍数），范围外的dst不变，供只在已到达的几行附近扩展的调用者使用
+    static bool Expand(const BasicBitboard& src, const BasicBitboard& mask, BasicBitboard& dst, int begin = 0, int end = SPAN);
+
+    //从seed出发、只经过passable中的格子能到达的所有格子（seed中不在passable里的格子不算起点）
+    static BasicBitboard Reachable(const BasicBitboard& seed, const BasicBitboard& passable)
+    {
+        BasicBitboard a = seed & passable;
+        BasicBitboard b;
+        while (Expand(a, passable, b) && Expand(b, passable, a))
+        {
+        }
+        return a | b;
+    }
+};
+
+//左右移位的列掩码：向东移后第0列的位来自上一行的最后一列，向西移后最后一列的位来自下一行的第0列
+template <class B>
+inline constexpr BasicBitboard<B> BITBOARD_NOT_WEST = BasicBitboard<B>::ColumnsExcept(0);
+template <class B>
+inline constexpr BasicBitboard<B> BITBOARD_NOT_EAST = BasicBitboard<B>::ColumnsExcept(B::Width() - 1);
+
+template <class B>
+BasicBitboard<B> BasicBitboard<B>::East() const
+{
+    return Shifted<1>() & BITBOARD_NOT_WEST<B>;
+}
+
+template <class B>
+BasicBitboard<B> BasicBitboard<B>::West() const
+{
+    return Shifted<-1>() & BITBOARD_NOT_EAST<B>;
+}
+
+template <class B>
+bool BasicBitboard<B>::Expand(const BasicBitboard& src, const BasicBitboard& mask, BasicBitboard& dst, int begin, int end)
+{
+    const uint64_t* s = src.Bits();
+    const uint64_t* notWest = BITBOARD_NOT_WEST<B>.Bits();
+    const uint64_t* notEast = BITBOARD_NOT_EAST<B>.Bits();
+    const uint64_t* m = mask.Bits();
+    uint64_t* d = dst.Bits();
+#if defined(__AVX2__)
+    __m256i changed = _mm256_setzero_si256();
+    for (int i = begin; i < end; i += 4)
+    {
+        const __m256i self = _mm256_load_si256(reinterpret_cast<const __m256i*>(s + i));
+        const __m256i east = _mm256_and_si256(ShiftVec<1>(s, i), _mm256_load_si256(reinterpret_cast<const __m256i*>(notWest + i)));
+        const __m256i west = _mm256_and_si256(ShiftVec<-1>(s, i), _mm256_load_si256(reinterpret_cast<const __m256i*>(notEast + i)));
+        const __m256i vertical = _mm256_or_si256(ShiftVec<WIDTH>(s, i), ShiftVec<-WIDTH>(s, i));
+        const __m256i grown = _mm256_and_si256(_mm256_or_si256(_mm256_or_si256(self, vertical), _mm256_or_si256(east, west)),
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(m + i)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(d + i), grown);
+        changed = _mm256_or_si256(changed, _mm256_xor_si256(grown, self));
+    }
+    return !_mm256_testz_si256(changed, changed);
+#else
+    uint64_t changed = 0;
+    for (int i = begin; i < end; i++)
+    {
+        const uint64_t grown = (s[i] | ShiftWord<WIDTH>(s, i) | ShiftWord<-WIDTH>(s, i)
+            | (ShiftWord<1>(s, i) & notWest[i]) | (ShiftWord<-1>(s, i) & notEast[i])) & m[i];
+        d[i] = grown;
+        changed |= grown ^ s[i];
+    }
+    return changed != 0;
+#endif
+}
+
+using Bitboard = BasicBitboard<StandardBoard>;
@@ -0,0 +1,232 @@
+﻿// Board.h - 棋盘网格、占用位图与空闲格索引
+// 棋盘尺寸是模板参数：常用尺寸在编译期确定（小棋盘用对象内的定长数组，循环边界是常量），
+// 另有运行期指定尺寸的DynamicBoard作为兜底
+#pragma once
+#include "GameDefs.h"
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "GameRng.h"
+
+//网格尺寸（以MYSIZE为单位）
+constexpr int GRID_WIDTH = WIDTH / MYSIZE;
+constexpr int GRID_HEIGHT = HEIGHT / MYSIZE;
+constexpr int GRID_CELLS = GRID_WIDTH * GRID_HEIGHT;
+
+//格子数不超过此值的编译期棋盘把全部状态放在对象内部（可在栈上），更大的放在堆上
+constexpr int STACK_BOARD_LIMIT = 4096;
+
+//像素坐标是否在标准场地内
+inline bool InBoard(int x, int y)
+{
+    return x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT;
+}
+
+//像素坐标转换为标准场地的格子编号（调用者需保证在场地内）
+inline int CellOf(int x, int y)
+{
+    return (y / MYSIZE) * GRID_WIDTH + (x / MYSIZE);
+}
+
+//标准场地的格子编号转换回像素坐标
+inline int CellX(int cell) { return (cell % GRID_WIDTH) * MYSIZE; }
+inline int CellY(int cell) { return (cell / GRID_WIDTH) * MYSIZE; }
+
+//定长存储：元素直接放在对象内部
+template <class T, size_t N>
+struct FixedArray
+{
+    using value_type = T;
+    T data[N];
+
+    void Init(size_t) {}
+    static constexpr size_t size() { return N; }
+    T& operator[](size_t i) { return data[i]; }
+    const T& operator[](size_t i) const { return data[i]; }
+};
+
+//堆存储：长度在运行期由Init确定
+template <class T>
+struct HeapArray
+{
+    using value_type = T;
+    std::vector<T> data;
+
+    void Init(size_t n) { data.assign(n, T()); }
+    size_t size() const { return data.size(); }
+    T& operator[](size_t i) { return data[i]; }
+    const T& operator[](size_t i) const { return data[i]; }
+};
+
+//能容纳N个格子编号的最小无符号类型
+template <long long N>
+using CellTypeFor = typename std::conditional<(N <= 256), uint8_t,
+    typename std::conditional<(N <= 65536), uint16_t, uint32_t>::type>::type;
+
+//编译期尺寸的棋盘：W x H格，格子编号类型为C
+template <int W, int H, class C = CellTypeFor<(long long)W * H>>
+class Board
+{
+    static_assert(W > 0 && H > 0, "运行期尺寸请使用DynamicBoard");
+
+public:
+    using Cell = C;
+    static constexpr int CELLS = W * H;
+    static constexpr int WORDS = (CELLS + 63) / 64;
+    static constexpr bool ON_STACK = CELLS <= STACK_BOARD_LIMIT;
+
+    //长度为N的数组：小棋盘用定长数组，大棋盘用堆
+    template <class T, size_t N>
+    using Storage = typename std::conditional<ON_STACK, FixedArray<T, N>, HeapArray<T>>::type;
+
+    static constexpr int Width() { return W; }
+    static constexpr int Height() { return H; }
+    static constexpr int Cells() { return CELLS; }
+    static constexpr int Words() { return WORDS; }
+    static constexpr int MaxLength() { return CELLS; }     //蛇身最大节数
+
+    static constexpr bool Contains(int gx, int gy) { return gx >= 0 && gx < W && gy >= 0 && gy < H; }
+    static constexpr int CellAt(int gx, int gy) { return gy * W + gx; }
+    static constexpr int Col(int cell) { return cell % W; }
+    static constexpr int Row(int cell) { return cell / W; }
+};
+
+//运行期尺寸的棋盘，所有存储都在堆上
+template <class C>
+class Board<0, 0, C>
+{
+private:
+    int w;
+    int h;
+
+public:
+    using Cell = C;
+    static constexpr int CELLS = 0;
+    static constexpr int WORDS = 0;
+    static constexpr bool ON_STACK = false;
+
+    template <class T, size_t N>
+    using Storage = HeapArray<T>;
+
+    Board(int width = GRID_WIDTH, int height = GRID_HEIGHT) : w(width), h(height) {}
+
+    int Width() const { return w; }
+    int Height() const { return h; }
+    int Cells() const { return w * h; }
+    int Words() const { return (w * h + 63) / 64; }
+    int MaxLength() const { return w * h; }
+
+    bool Contains(int gx, int gy) const { return gx >= 0 && gx < w && gy >= 0 && gy < h; }
+    int CellAt(int gx, int gy) const { return gy * w + gx; }
+    int Col(int cell) const { return cell % w; }
+    int Row(int cell) const { return cell / w; }
+};
+
+//常用尺寸
+using TinyBoard = Board<16, 16>;                            //AI训练用小棋盘
+using StandardBoard = Board<GRID_WIDTH, GRID_HEIGHT>;       //标准52x32
+using LargeBoard = Board<512, 512, uint32_t>;               //大型竞技场，存储在堆上
+using DynamicBoard = Board<0, 0, uint32_t>;                 //运行期指定尺寸
+
+//标准场地的格子编号类型
+using CellIndex = StandardBoard::Cell;
+
+//占用位图：每个格子一位，由蛇在移动时增量维护
+template <class B>
+class BasicOccupancy
+{
+private:
+    typename B::template Storage<uint64_t, B::WORDS> bits;
+
+public:
+    explicit BasicOccupancy(const B& board = B())
+    {
+        bits.Init(board.Words());
+        Clear();
+    }
+
+    void Clear()
+    {
+        for (size_t i = 0; i < bits.size(); i++)
+            bits[i] = 0;
+    }
+
+    bool Test(int cell) const { return (bits[cell >> 6] >> (cell & 63)) & 1; }
+    void Set(int cell) { bits[cell >> 6] |= uint64_t(1) << (cell & 63); }
+    void Reset(int cell) { bits[cell >> 6] &= ~(uint64_t(1) << (cell & 63)); }
+    const uint64_t* Words() const { return &bits[0]; }     //按格子编号逐位存放，可直接拷入位棋盘
+};
+
+//空闲格索引：空闲格子紧凑存放在cells前freeCount项，slot记录每个格子在cells中的位置
+//占用/释放都是与末尾交换，O(1)；随机取一个空闲格只需一次均匀抽样
+template <class B>
+class BasicFreeCells
+{
+private:
+    using Cell = typename B::Cell;
+    typename B::template Storage<Cell, B::CELLS> cells;
+    typename B::template Storage<Cell, B::CELLS> slot;
+    int freeCount;
+
+public:
+    explicit BasicFreeCells(const B& board = B())
+    {
+        cells.Init(board.Cells());
+        slot.Init(board.Cells());
+        Clear();
+    }
+
+    //所有格子置为空闲
+    void Clear()
+    {
+        const int n = static_cast<int>(cells.size());
+        for (int i = 0; i < n; i++)
+        {
+            cells[i] = static_cast<Cell>(i);
+            slot[i] = static_cast<Cell>(i);
+        }
+        freeCount = n;
+    }
+
+    int Count() const { return freeCount; }
+    bool IsFree(int cell) const { return static_cast<int>(slot[cell]) < freeCount; }
+
+    //标记格子被占用（调用者需保证该格当前空闲）
+    void Take(int cell)
+    {
+        const Cell pos = slot[cell];
+        const Cell last = cells[--freeCount];
+        cells[pos] = last;
+        slot[last] = pos;
+        cells[freeCount] = static_cast<Cell>(cell);
+        slot[cell] = static_cast<Cell>(freeCount);
+    }
+
+    //标记格子重新空闲（调用者需保证该格当前被占用）
+    void Release(int cell)
+    {
+        const Cell pos = slot[cell];
+        const Cell first = cells[freeCount];
+        cells[pos] = first;
+        slot[first] = pos;
+        cells[freeCount] = static_cast<Cell>(cell);
+        slot[cell] = static_cast<Cell>(freeCount++);
+    }
+
+    //第i个空闲格，i需在[0, Count())内
+    int At(int i) const { return cells[i]; }
+    //空闲格cell在At中的序号，At(Rank(cell)) == cell；cell需当前空闲
+    int Rank(int cell) const { return slot[cell]; }
+
+    //从空闲格中均匀抽取一个；没有空闲格时返回-1
+    int Pick(CounterRng& rng) const
+    {
+        if (freeCount == 0)
+            return -1;
+        return cells[rng.Below(static_cast<uint32_t>(freeCount))];
+    }
+};
+
+using Occupancy = BasicOccupancy<StandardBoard>;
+using FreeCells = BasicFreeCells<StandardBoard>;
@@ -0,0 +1,190 @@
+﻿// EventBus.h - 模拟事件总线：核心在逻辑帧中发出带类型的事件，存档、绘制、统计等订阅者各自取用
+// 每个订阅者有自己的单生产者单消费者无锁队列（SpscRing），生产者是推进逻辑帧的线程，
+// 订阅者可以在各自的线程中取事件，互不等待；某个订阅者的队列满时只丢弃投给它的这条事件并计数，逻辑帧从不阻塞
+// 存档这类不能丢事件的订阅者登记为无损：队列满时事件按顺序暂存在生产者一侧的溢出表中，
+// 之后每次投递（或生产者调用Pump）先把溢出表中的事件补进队列，订阅者收到的顺序不变
+// 每个订阅者的积压、峰值积压、已投递、溢出和已丢弃的事件数都可随时读取，作为监控指标
+#pragma once
+#include "SpscRing.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+enum class GameEventType : uint8_t
+{
+    GAME_STARTED,       //新的一局开始，上一局剩下的食物随之清空：kind为开局朝向，位置为蛇头
+    DIRECTION_CHANGED,  //本帧接受了一次转向：kind为新方向，位置为蛇头
+    FOOD_SPAWNED,       //食物出现：kind为种类，位置为食物，value为分值
+    FOOD_EATEN,         //吃到食物：同上，score等为吃到之后的值
+    FOOD_EXPIRED,       //限时食物超时消失：同FOOD_SPAWNED
+    DIED,               //蛇死亡，本局结束：kind为死因（GAME_DEATH_*），位置为蛇头
+    BOARD_FULL,         //没有格子能再放食物，本局以获胜结束：位置为蛇头
+    COUNT
+};
+
+constexpr uint8_t GAME_DEATH_WALL = 0;     //出界或撞墙
+constexpr uint8_t GAME_DEATH_SELF = 1;     //撞到自己
+
+//订阅时按位选择关心的事件类型
+constexpr uint32_t EventBit(GameEventType type) { return 1u << static_cast<int>(type); }
+constexpr uint32_t EVENT_MASK_ALL = (1u << static_cast<int>(GameEventType::COUNT)) - 1;
+
+//一条事件；蛇的分数、长度等随每条事件附带，订阅者不需要再回头读核心的状态
+struct GameEvent
+{
+    GameEventType type;
+    uint8_t kind;       //食物种类（FoodKind）、方向（Direction）或死因
+    uint32_t tick;      //发生时的逻辑帧
+    int32_t x;          //像素坐标，与StepEvents相同
+    int32_t y;
+    int32_t value;      //食物的分值
+    int32_t score;      //蛇的分数
+    int32_t length;     //蛇的长度
+    int32_t count;      //吃到的普通食物数（大食物计数），与Snake::GetCount相同
+    uint64_t seed;      //本局种子
+};
+
+constexpr size_t EVENT_RING_SIZE = 1024;    //每个订阅者的队列容量
+constexpr int MAX_EVENT_SUBSCRIBERS = 8;
+
+class EventBus
+{
+public:
+    //一个订阅者的监控指标，任意线程都可读取，并发时为近似值
+    struct Metrics
+    {
+        const char* name;
+        size_t backlog;         //已发出、尚未取走的事件数，含溢出表中的
+        size_t peak;            //积压的历史最大值
+        uint64_t delivered;     //已放进队列的事件数
+        uint64_t spilled;       //因队列满而先进入溢出表的事件数（只有无损订阅者）
+        uint64_t dropped;       //因队列满而丢弃的事件数（无损订阅者总是0）
+    };
+
+private:
+    struct Subscriber
+    {
+        SpscRing<GameEvent, EVENT_RING_SIZE> ring;
+        const char* name;
+        uint32_t mask;
+        bool lossless;
+        std::vector<GameEvent> spill;       //无损订阅者的溢出表，只有生产者访问
+        size_t spillHead;                   //溢出表中下一条要补进队列的事件
+        //以下只由生产者写入
+        std::atomic<uint64_t> delivered;
+        std::atomic<uint64_t> spilled;
+        std::atomic<uint64_t> dropped;
+        std::atomic<size_t> pending;        //溢出表中的事件数
+        std::atomic<size_t> peak;
+
+        Subscriber(const char* name, uint32_t mask, bool lossless) : name(name), mask(mask), lossless(lossless),
+            spillHead(0), delivered(0), spilled(0), dropped(0), pending(0), peak(0) {}
+    };
+
+    std::unique_ptr<Subscriber> subscribers[MAX_EVENT_SUBSCRIBERS];
+    int count;
+
+    //只有生产者写的计数器：读出加一再存回，不需要原子的读改写
+    template <class T>
+    static void Bump(std::atomic<T>& counter, T by = 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    static void Delivered(Subscriber& s)
+    {
+        Bump(s.delivered);
+        const size_t backlog = s.ring.Size() + s.pending.load(std::memory_order_relaxed);
+        if (backlog > s.peak.load(std::memory_order_relaxed))
+            s.peak.store(backlog, std::memory_order_relaxed);
+    }
+
+    //把溢出表中的事件按顺序补进队列，返回溢出表是否已清空
+    static bool Drain(Subscriber& s)
+    {
+        while (s.spillHead < s.spill.size() && s.ring.Push(s.spill[s.spillHead]))
+        {
+            s.spillHead++;
+            s.pending.store(s.spill.size() - s.spillHead, std::memory_order_relaxed);
+            Delivered(s);
+        }
+        if (s.spillHead < s.spill.size())
+            return false;
+        s.spill.clear();
+        s.spillHead = 0;
+        return true;
+    }
+
+public:
+    EventBus() : count(0) {}
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    //登记一个订阅者，返回其编号；须在开始投递之前调用，订阅者已满时返回-1
+    //lossless为true时队列满也不丢事件，而是暂存到溢出表（内存随积压增长），用于存档等必须完整记录的订阅者
+    int Subscribe(const char* name, uint32_t mask = EVENT_MASK_ALL, bool lossless = false)
+    {
+        if (count == MAX_EVENT_SUBSCRIBERS)
+            return -1;
+        subscribers[count] = std::make_unique<Subscriber>(name, mask, lossless);
+        return count++;
+    }
+
+    int SubscriberCount() const { return count; }
+
+    //生产者调用：投给每个订阅了该类型的订阅者
+    void Publish(const GameEvent& event)
+    {
+        const uint32_t bit = EventBit(event.type);
+        for (int i = 0; i < count; i++)
+        {
+            Subscriber& s = *subscribers[i];
+            if (!(s.mask & bit))
+                continue;
+            //无损订阅者的溢出表没清空时，新事件排在它们后面
+            if ((!s.lossless || Drain(s)) && s.ring.Push(event))
+            {
+                Delivered(s);
+            }
+            else if (s.lossless)
+            {
+                s.spill.push_back(event);
+                s.pending.store(s.spill.size() - s.spillHead, std::memory_order_relaxed);
+                Bump(s.spilled);
+            }
+            else
+            {
+                Bump(s.dropped);
+            }
+        }
+    }
+
+    //生产者调用：不投递新事件时把溢出表中的事件补进队列，返回是否还有事件留在溢出表中
+    //等待订阅者处理完所有事件之前（如结束一局、退出）应反复调用，直到返回false
+    bool Pump()
+    {
+        bool left = false;
+        for (int i = 0; i < count; i++)
+        {
+            if (subscribers[i]->lossless && !Drain(*subscribers[i]))
+                left = true;
+        }
+        return left;
+    }
+
+    //订阅者id调用：取出最早的一条事件，没有时返回false
+    bool Poll(int id, GameEvent& event)
+    {
+        return subscribers[id]->ring.Pop(event);
+    }
+
+    Metrics GetMetrics(int id) const
+    {
+        const Subscriber& s = *subscribers[id];
+        return { s.name, s.ring.Size() + s.pending.load(std::memory_order_relaxed), s.peak.load(std::memory_order_relaxed),
+            s.delivered.load(std::memory_order_relaxed), s.spilled.load(std::memory_order_relaxed),
+            s.dropped.load(std::memory_order_relaxed) };
+    }
+};
@@ -0,0 +1,71 @@
+﻿// FixedTimestep.cpp - 固定步长调度器实现
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(int periodMs, int maxCatchUp)
+    : period(std::chrono::milliseconds(periodMs > 0 ? periodMs : 1)),
+    accumulator(0), maxCatchUp(maxCatchUp > 0 ? maxCatchUp : 1),
+    windowTicks(0), windowFrames(0), tickRate(0.0), frameRate(0.0)
+{
+    Reset();
+}
+
+void FixedTimestep::SetPeriod(int periodMs)
+{
+    period = std::chrono::milliseconds(periodMs > 0 ? periodMs : 1);
+}
+
+int FixedTimestep::GetPeriod() const
+{
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(period).count());
+}
+
+void FixedTimestep::Reset()
+{
+    last = Clock::now();
+    accumulator = Clock::duration::zero();
+    windowStart = last;
+    windowTicks = 0;
+    windowFrames = 0;
+}
+
+int FixedTimestep::Advance()
+{
+    const Clock::time_point now = Clock::now();
+    accumulator += now - last;
+    last = now;
+
+    int ticks = 0;
+    while (accumulator >= period && ticks < maxCatchUp)
+    {
+        accumulator -= period;
+        ticks++;
+    }
+    //补帧已到上限，剩余积压只保留不足一帧的部分，避免卡顿后连续快进
+    if (accumulator >= period)
+    {
+        accumulator %= period;
+    }
+
+    windowTicks += ticks;
+    windowFrames++;
+    const double elapsed = std::chrono::duration<double>(now - windowStart).count();
+    if (elapsed >= 1.0)
+    {
+        tickRate = windowTicks / elapsed;
+        frameRate = windowFrames / elapsed;
+        windowStart = now;
+        windowTicks = 0;
+        windowFrames = 0;
+    }
+    return ticks;
+}
+
+double FixedTimestep::TickRate() const
+{
+    return tickRate;
+}
+
+double FixedTimestep::FrameRate() const
+{
+    return frameRate;
+}
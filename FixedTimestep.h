@@ -0,0 +1,34 @@
+﻿// FixedTimestep.h - 基于单调时钟的固定步长调度器
+// 逻辑帧按固定周期推进，与绘制帧解耦；卡顿后最多补若干帧，多余的积压直接丢弃
+#pragma once
+#include <chrono>
+
+class FixedTimestep
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Clock::duration period;         //逻辑帧周期
+    Clock::duration accumulator;    //尚未消耗的时间
+    Clock::time_point last;         //上一次Advance的时间
+    int maxCatchUp;                 //一次Advance最多补的逻辑帧数
+
+    //帧率统计（每秒刷新一次）
+    Clock::time_point windowStart;
+    int windowTicks;
+    int windowFrames;
+    double tickRate;
+    double frameRate;
+
+public:
+    FixedTimestep(int periodMs, int maxCatchUp = 5);
+
+    void SetPeriod(int periodMs);
+    int GetPeriod() const;          //毫秒
+    void Reset();                   //清空积压并从当前时刻重新计时（如暂停、结束界面返回后）
+    int Advance();                  //每个绘制帧调用一次，返回本帧应推进的逻辑帧数
+
+    double TickRate() const;        //实测逻辑帧率（次/秒）
+    double FrameRate() const;       //实测绘制帧率（次/秒）
+};
@@ -0,0 +1,153 @@
+﻿// FloodFill.h - 位棋盘上的可达区域内核，供AI判断走法是否安全、检测死路和校验关卡
+// 从起点逐步扩展：每一步把已到达的格子向四邻扩一格再与可通行格相与（BasicBitboard::Expand），
+// 第k步新到达的格子就是BFS中距离为k的一层，所以除了面积，也能给出到达某一格所需的步数
+// 可选的释放表记录暂时被占、第t步起才空出来的格子（蛇身从尾部起每走一步让出一节），
+// 扩展到第t步时才并入可通行格，回答"跟着尾巴走能否脱困"这类与时间有关的问题；
+// 已到达的格子不再变化时，只有它们的数目够蛇走到下一个释放时间才继续等待（蛇不能停在原地）
+// 每一步只重算上一步有变化的行和新释放的格子附近的字，已经填满的区域不再参与运算；
+// 大棋盘的空场上菱形波前覆盖的行每步都在变，这时只比逐格BFS略快（见bench/FloodBench）
+// 与Bitboard.h相同，不跨越棋盘边缘，不表示环面和传送门
+#pragma once
+#include "Bitboard.h"
+#include "snake.h"
+#include <algorithm>
+#include <vector>
+
+//一次扩展的结果
+struct FloodResult
+{
+    int cells;          //能到达的格子数，不含起点
+    int steps;          //最后一次有新格子到达的步数
+    int targetStep;     //第一次到达目标格的步数，没有目标或到不了时为-1
+};
+
+constexpr int FLOOD_NO_TARGET = -1;
+
+//B为编译期尺寸的棋盘；释放表在多次Run之间保留，同一局面试探多个走法时只需登记一次
+template <class B>
+class BasicFloodFill
+{
+public:
+    using Bits = BasicBitboard<B>;
+
+private:
+    struct Release
+    {
+        int time;       //从第time步起可以进入
+        int cell;
+    };
+    std::vector<Release> releases;  //按time从小到大
+
+    //上下移一行时一个字的位最多落到相隔WIDTH/64+1个字的位置
+    static constexpr int ROW_REACH = Bits::WIDTH / 64 + 1;
+
+public:
+    void ClearReleases() { releases.clear(); }
+    size_t ReleaseCount() const { return releases.size(); }
+
+    //登记cell从第time步起空出；time不大于0的格子在第一步之前就并入可通行格
+    void AddRelease(int cell, int time)
+    {
+        //通常按时间顺序登记，直接追加；乱序时插到同一时间的最后
+        const Release r = { time, cell };
+        if (releases.empty() || releases.back().time <= time)
+        {
+            releases.push_back(r);
+            return;
+        }
+        const auto at = std::upper_bound(releases.begin(), releases.end(), r,
+            [](const Release& a, const Release& b) { return a.time < b.time; });
+        releases.insert(at, r);
+    }
+
+    //按蛇身登记：共L节时，从蛇头数第i节（蛇头为第0节）在L-i步后让出（此时蛇头恰好可以跟进尾巴原来的格子）；
+    //elapsed为试探的起点已经走过的步数，刚吃到食物时尾部晚一步让出；之后再吃到的食物不计
+    void ReleaseSnake(const BasicSnake<B>& snake, int elapsed = 0)
+    {
+        const int length = static_cast<int>(snake.getsize());
+        const int delay = snake.IsGrowing() ? 1 : 0;
+        for (int i = length - 1; i >= 0; i--)
+            AddRelease(static_cast<int>(snake.GetCell(static_cast<size_t>(i))), length - i - elapsed + delay);
+    }
+
+    //从start出发、经过passable和到时已释放的格子，逐步扩展到不再变化；start中的格子总是算作已到达
+    //target不为FLOOD_NO_TARGET时记录到达它的步数，stopAtTarget为true时到达后立即返回（此时cells只是目前的面积）
+    FloodResult Run(const Bits& start, const Bits& passable, int target = FLOOD_NO_TARGET, bool stopAtTarget = false) const
+    {
+        Bits open = passable | start;
+        Bits reach = start;
+        Bits grown;
+        FloodResult result = { 0, 0, FLOOD_NO_TARGET };
+        if (target != FLOOD_NO_TARGET && start.Test(target))
+        {
+            result.targetStep = 0;
+            if (stopAtTarget)
+                return result;
+        }
+
+        //下一步可能变化的字的范围：上一步变化过的字和新释放的格子上下各放宽一行，其余的字不会再变
+        const uint64_t* words = start.Words();
+        int first = 0;
+        while (first < Bits::WORDS && words[first] == 0)
+            first++;
+        if (first == Bits::WORDS)
+            return result;
+        int last = Bits::WORDS - 1;
+        while (words[last] == 0)
+            last--;
+        int lo = first;
+        int hi = last + 1;
+
+        const int startCount = start.Count();
+        int counted = 0;    //上次数到的已到达格子数（不含起点）；reach只增不减，它一直是当前数目的下界
+        size_t r = 0;
+        for (int step = 1;; step++)
+        {
+            for (; r < releases.size() && releases[r].time <= step; r++)
+            {
+                open.Set(releases[r].cell);
+                lo = std::min(lo, releases[r].cell >> 6);
+                hi = std::max(hi, (releases[r].cell >> 6) + 1);
+            }
+
+            bool changed = false;
+            if (lo < hi)
+            {
+                lo = std::max(0, lo - ROW_REACH) & ~3;
+                hi = std::min(Bits::SPAN, (hi + ROW_REACH + 3) & ~3);
+                Bits::Expand(reach, open, grown, lo, hi);
+                changed = reach.AssignRange(grown, lo, hi, first, last);
+            }
+            if (!changed)
+            {
+                //本步没有新格子，要等下一个释放时间；蛇不能停在原地，只有已到达的格子够它一格一格地走到那时才等得到
+                //下界已经够时不再重数整张棋盘：大棋盘上逐格让出的长蛇身会让这里执行上千次
+                if (r == releases.size())
+                    break;
+                if (releases[r].time - 1 > counted)
+                {
+                    counted = reach.Count() - startCount;
+                    if (releases[r].time - 1 > counted)
+                        break;
+                }
+                step = std::max(step, releases[r].time - 1);
+                lo = Bits::SPAN;
+                hi = 0;
+                continue;
+            }
+            lo = first;
+            hi = last + 1;
+            result.steps = step;
+            if (result.targetStep < 0 && target != FLOOD_NO_TARGET && reach.Test(target))
+            {
+                result.targetStep = step;
+                if (stopAtTarget)
+                    break;
+            }
+        }
+        result.cells = reach.Count() - startCount;
+        return result;
+    }
+};
+
+using FloodFill = BasicFloodFill<StandardBoard>;
@@ -0,0 +1,205 @@
+﻿// FoodPool.h - 数据导向的食物池
+// 所有食物的格子、种类、分值和过期定时器分别存放在定长数组中，活跃食物紧凑排在前Count()项，
+// 另有一张格子->下标的网格，蛇头查食物只需一次数组访问，场上同时存在多少食物都不影响Eat的开销
+// 新增食物种类只需在FoodKind和FOOD_TYPES中各加一项，无需新增类；实际分值和存在时间由GameRules给出
+#pragma once
+#include "SpatialIndex.h"
+#include "TimerWheel.h"
+#include "GameRng.h"
+#include "Zobrist.h"
+#include <cstdint>
+
+constexpr int FOOD_POOL_CAPACITY = 64;      //同时存在的食物上限
+constexpr int FOOD_SPAWN_TRIES = 64;        //随机抽取位置的重抽次数
+static_assert(FOOD_POOL_CAPACITY <= 127, "食物下标存放在int8_t的格子索引中");
+
+//食物种类，作为FOOD_TYPES的下标
+enum FoodKind : uint8_t
+{
+    FOOD_NORMAL = 0,
+    FOOD_BIG = 1,
+    FOOD_KINDS
+};
+
+static_assert(ZOBRIST_FOOD + FOOD_KINDS <= ZOBRIST_PIECES, "食物种类超出Zobrist键的种类数");
+
+//食物种类的属性表
+struct FoodType
+{
+    const char* name;   //写入food_records.food_type的名称
+    int score;          //默认分值
+    int lifetime;       //存在的毫秒数，0表示不会过期；GameRules按逻辑帧周期换算成帧数
+};
+
+inline constexpr FoodType FOOD_TYPES[FOOD_KINDS] =
+{
+    { "NORMAL", 1, 0 },
+    { "BIG", 5, BIGFOOD_DURATION },
+};
+
+//[0, n)内的均匀随机数；n在32位以内时与rng.Below消耗相同，超出时（稀疏棋盘）取模的偏差可以忽略
+template <class I>
+inline I DrawBelow(CounterRng& rng, I n)
+{
+    if (static_cast<uint64_t>(n) <= UINT32_MAX)
+        return static_cast<I>(rng.Below(static_cast<uint32_t>(n)));
+    return static_cast<I>(rng.Next() % static_cast<uint64_t>(n));
+}
+
+//B为棋盘类型；小棋盘上全部是定长数组，食物池可随GameState按字节复制
+template <class B>
+class BasicFoodPool
+{
+public:
+    using Cell = typename B::Cell;
+
+private:
+    Cell cells[FOOD_POOL_CAPACITY];
+    uint8_t kinds[FOOD_POOL_CAPACITY];
+    int32_t values[FOOD_POOL_CAPACITY];
+    TimerId expiry[FOOD_POOL_CAPACITY];     //过期定时器，不会过期时为TIMER_NONE
+    int count;
+    int kindCount[FOOD_KINDS];
+    const uint64_t* eligible;               //可生成食物的格子位图（映射的关卡文件中），nullptr表示不限
+    SpatialIndex<B, int8_t> slotOf;         //格子 -> 食物下标，没有食物时为CELL_EMPTY
+    uint64_t hash;                          //所有食物的Zobrist键的异或
+
+public:
+    explicit BasicFoodPool(const B& board = B()) : count(0), kindCount{}, eligible(nullptr), slotOf(board), hash(0) {}
+
+    void SetEligible(const uint64_t* mask) { eligible = mask; }
+
+    //只清除已有食物所在的格子，不必扫描整个网格
+    void Clear()
+    {
+        for (int i = 0; i < count; i++)
+            slotOf.Set(cells[i], CELL_EMPTY);
+        count = 0;
+        for (int k = 0; k < FOOD_KINDS; k++)
+            kindCount[k] = 0;
+        hash = 0;
+    }
+
+    int Count() const { return count; }
+    int Count(uint8_t kind) const { return kindCount[kind]; }
+    bool Full() const { return count == FOOD_POOL_CAPACITY; }
+    bool CanPlace(int64_t cell) const
+    {
+        return Find(static_cast<Cell>(cell)) < 0 && (eligible == nullptr || ((eligible[cell >> 6] >> (cell & 63)) & 1));
+    }
+
+    //格子上食物的下标，没有食物时为-1
+    int Find(Cell cell) const { return slotOf.Get(cell); }
+
+    //在空格子上放一个食物，返回其下标；池已满或格子上已有食物时返回-1
+    int Add(Cell cell, uint8_t kind, int value)
+    {
+        if (Full() || Find(cell) >= 0)
+            return -1;
+        const int i = count++;
+        cells[i] = cell;
+        kinds[i] = kind;
+        values[i] = value;
+        expiry[i] = TIMER_NONE;
+        kindCount[kind]++;
+        slotOf.Set(cell, i);
+        hash ^= ZobristFood(kind, cell);
+        return i;
+    }
+
+    //移除第i个食物：与末尾交换，O(1)；之后末尾食物的下标变为i
+    void Remove(int i)
+    {
+        kindCount[kinds[i]]--;
+        slotOf.Set(cells[i], CELL_EMPTY);
+        hash ^= ZobristFood(kinds[i], cells[i]);
+        const int last = --count;
+        if (i != last)
+        {
+            cells[i] = cells[last];
+            kinds[i] = kinds[last];
+            values[i] = values[last];
+            expiry[i] = expiry[last];
+            slotOf.Set(cells[i], i);
+        }
+    }
+
+    //在蛇以外的空闲格中均匀抽取位置放一个食物，返回其下标；池已满或没有可放食物的格子时返回-1
+    //只有与其他食物重叠或不在可生成位图中时才重抽，场上只有一个食物且没有关卡时与直接抽取消耗的随机数相同
+    //重抽FOOD_SPAWN_TRIES次仍失败时按空闲格索引的序号精确抽取，开销与食物数（有关卡时与空闲格数）成正比
+    template <class S>
+    int Spawn(const S& snake, CounterRng& rng, uint8_t kind, int value)
+    {
+        if (Full())
+            return -1;
+        const auto& freeCells = snake.GetFreeCells();
+        for (int t = 0; t < FOOD_SPAWN_TRIES; t++)
+        {
+            const int64_t picked = freeCells.Pick(rng);
+            if (picked < 0)
+                return -1;
+            if (CanPlace(picked))
+                return Add(static_cast<Cell>(picked), kind, value);
+        }
+
+        //重抽仍失败说明空闲格几乎都被食物或关卡排除，直接从空闲格索引中定位，不扫描棋盘
+        using Index = decltype(freeCells.Count());
+        const Index freeCount = freeCells.Count();
+        if (eligible == nullptr)
+        {
+            //在空闲格序号中跳过有食物的格子：按序号从小到大，不超过k的每个食物让k后移一位
+            Index ranks[FOOD_POOL_CAPACITY];
+            int skipped = 0;
+            for (int i = 0; i < count; i++)
+            {
+                if (!freeCells.IsFree(cells[i]))
+                    continue;
+                const Index rank = static_cast<Index>(freeCells.Rank(cells[i]));
+                int j = skipped++;
+                for (; j > 0 && ranks[j - 1] > rank; j--)
+                    ranks[j] = ranks[j - 1];
+                ranks[j] = rank;
+            }
+            const Index available = freeCount - skipped;
+            if (available <= 0)
+                return -1;
+            Index k = DrawBelow<Index>(rng, available);
+            for (int j = 0; j < skipped && ranks[j] <= k; j++)
+                k++;
+            return Add(static_cast<Cell>(freeCells.At(k)), kind, value);
+        }
+
+        //关卡限制了可生成的格子（只在稠密棋盘上）：两遍遍历空闲格，先计数再定位
+        Index available = 0;
+        for (Index i = 0; i < freeCount; i++)
+            available += CanPlace(freeCells.At(i)) ? 1 : 0;
+        if (available == 0)
+            return -1;
+        Index k = DrawBelow<Index>(rng, available);
+        for (Index i = 0; i < freeCount; i++)
+        {
+            const int64_t cell = freeCells.At(i);
+            if (CanPlace(cell) && k-- == 0)
+                return Add(static_cast<Cell>(cell), kind, value);
+        }
+        return -1;
+    }
+
+    uint64_t Hash() const { return hash; }
+    //不用增量值、从头计算的哈希，用于校验
+    uint64_t ComputeHash() const
+    {
+        uint64_t h = 0;
+        for (int i = 0; i < count; i++)
+            h ^= ZobristFood(kinds[i], cells[i]);
+        return h;
+    }
+
+    Cell CellAt(int i) const { return cells[i]; }
+    uint8_t KindAt(int i) const { return kinds[i]; }
+    int ValueAt(int i) const { return values[i]; }
+    TimerId ExpiryAt(int i) const { return expiry[i]; }
+    void SetExpiry(int i, TimerId id) { expiry[i] = id; }
+};
+
+using FoodPool = BasicFoodPool<StandardBoard>;
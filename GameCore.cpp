@@ -0,0 +1,344 @@
+﻿// GameCore.cpp - 游戏规则的无界面实现
+#include "GameCore.h"
+#include <cstring>
+#include <utility>
+
+template <class B>
+BasicGameState<B>::BasicGameState(const B& board) : snake(board), foods(board), gameover(false), tick(0)
+{
+}
+
+template <class B>
+BasicGameState<B>::BasicGameState(uint64_t seed, const B& board) : rng(seed), snake(rng.color, board),
+foods(board), gameover(false), tick(0)
+{
+}
+
+template <class B>
+BasicGameCore<B>::BasicGameCore(uint64_t seed, const B& board, const GameRules& rules) : state(board), nextRules(rules),
+nextTopology(std::make_shared<const BasicTopology<B>>(board)), bus(nullptr)
+{
+    Reset(seed);
+}
+
+template <class B>
+void BasicGameCore<B>::Reset(uint64_t seed)
+{
+    state.rules = nextRules;
+    topology = nextTopology;
+    level = nextLevel;
+    state.snake.SetTopology(topology.get());
+    state.rng.Reseed(seed);
+
+    //有关卡时从第一个出生点出发，墙和可生成食物的格子直接指向映射中的位图，不做复制
+    const LevelView* view = GetLevel();
+    SnakeSpawn spawn{};
+    if (view != nullptr && view->SpawnCount() > 0)
+    {
+        const LevelSpawn& s = view->Spawn(0);
+        spawn = { s.x, s.y, static_cast<Direction>(s.dir) };
+    }
+    state.snake.SetWalls(view != nullptr ? view->WallBits() : nullptr);
+    state.foods.SetEligible(view != nullptr ? view->FoodBits() : nullptr);
+    state.snake.Reset(state.rng.color, state.rules.initialLength, state.rules.maxLength,
+        view != nullptr && view->SpawnCount() > 0 ? &spawn : nullptr);
+    state.foods.Clear();
+    state.gameover = false;
+    state.tick = 0;
+    state.timers.Clear(0);
+    Emit(GameEventType::GAME_STARTED, static_cast<uint8_t>(state.snake.GetDirection()), state.snake.GetHeadCell());
+    SpawnFood();
+}
+
+//附上蛇的当前状态投递一条事件；cell换算成像素坐标
+template <class B>
+void BasicGameCore<B>::Emit(GameEventType type, uint8_t kind, typename B::Cell cell, int value)
+{
+    if (bus == nullptr)
+        return;
+    const SnakeType& snake = state.snake;
+    GameEvent event;
+    event.type = type;
+    event.kind = kind;
+    event.tick = state.tick;
+    event.x = static_cast<int32_t>(snake.GetBoard().Col(cell) * MYSIZE);
+    event.y = static_cast<int32_t>(snake.GetBoard().Row(cell) * MYSIZE);
+    event.value = value;
+    event.score = snake.GetScore();
+    event.length = static_cast<int32_t>(snake.getsize());
+    event.count = snake.GetCount();
+    event.seed = GetSeed();
+    bus->Publish(event);
+}
+
+//按种类放一个食物；有存在时限的种类在时间轮上登记过期，以格子作为定时器的参数
+//没有可放的格子时返回-1，由Step结束本局
+template <class B>
+int BasicGameCore<B>::AddFood(uint8_t kind)
+{
+    const int i = state.foods.Spawn(state.snake, state.rng.food, kind, state.rules.foodScore[kind]);
+    if (i < 0)
+        return -1;
+    const int lifetime = state.rules.foodLifetime[kind];
+    if (lifetime > 0)
+    {
+        //存在lifetime帧，之后的下一帧过期
+        state.foods.SetExpiry(i, state.timers.Schedule(state.tick + lifetime + 1, TIMER_FOOD_EXPIRE,
+            static_cast<uint64_t>(state.foods.CellAt(i))));
+    }
+    Emit(GameEventType::FOOD_SPAWNED, kind, state.foods.CellAt(i), state.foods.ValueAt(i));
+    return i;
+}
+
+template <class B>
+void BasicGameCore<B>::SpawnFood()
+{
+    if (state.foods.Count(FOOD_NORMAL) == 0 && state.foods.Count(FOOD_BIG) == 0)
+    {
+        AddFood(FOOD_NORMAL);
+    }
+}
+
+template <class B>
+void BasicGameCore<B>::CheckBigFood(StepEvents& events)
+{
+    const SnakeType& snake = state.snake;
+    const int every = state.rules.bigFoodEvery;
+    if (every > 0 && snake.GetCount() % every == 0 && snake.GetCount() > 0 && state.foods.Count(FOOD_BIG) == 0)
+    {
+        if (AddFood(FOOD_BIG) >= 0)
+            events.flags |= EVENT_BIGFOOD_SPAWNED;
+    }
+
+    //触发本帧到期的定时事件；同一帧内再次调用时时间轮已在当前帧，不会重复触发
+    state.timers.Advance(state.tick, [&](uint16_t kind, uint64_t payload)
+    {
+        if (kind == TIMER_FOOD_EXPIRE)
+            ExpireFood(static_cast<typename B::Cell>(payload), events);
+    });
+}
+
+template <class B>
+void BasicGameCore<B>::ExpireFood(typename B::Cell cell, StepEvents& events)
+{
+    const int i = state.foods.Find(cell);
+    if (i < 0)
+        return;
+    const uint8_t kind = state.foods.KindAt(i);
+    Emit(GameEventType::FOOD_EXPIRED, kind, cell, state.foods.ValueAt(i));
+    state.foods.Remove(i);
+    if (kind == FOOD_BIG)
+    {
+        state.snake.setcount();
+        events.flags |= EVENT_BIGFOOD_EXPIRED;
+    }
+    SpawnFood();
+}
+
+//每帧最多检查MAX_INPUTS_PER_TICK条输入，只接受第一条有效转向（相对本帧将要移动的方向校验）
+//其余输入留在队列中供后续逻辑帧使用，因此一帧内的连续转向（如先上后左）不会丢失，也不会直接掉头
+template <class B>
+bool BasicGameCore<B>::ApplyInput(InputQueue& input)
+{
+    InputEvent event;
+    for (int i = 0; i < MAX_INPUTS_PER_TICK && input.Pop(event); i++)
+    {
+        if (state.snake.SetDirection(event.dir))
+            return true;
+    }
+    return false;
+}
+
+template <class B>
+StepEvents BasicGameCore<B>::Step(InputQueue& input)
+{
+    StepEvents events{};
+    if (state.gameover)
+    {
+        return events;
+    }
+
+    state.tick++;
+    if (ApplyInput(input))
+    {
+        events.flags |= EVENT_TURNED;
+        Emit(GameEventType::DIRECTION_CHANGED, static_cast<uint8_t>(state.snake.GetDirection()), state.snake.GetHeadCell());
+    }
+
+    CheckBigFood(events);
+
+    SnakeType& snake = state.snake;
+    const int eaten = snake.Eat(state.foods);
+    if (eaten >= 0)
+    {
+        const typename B::Cell cell = state.foods.CellAt(eaten);
+        const uint8_t kind = state.foods.KindAt(eaten);
+        events.flags |= kind == FOOD_BIG ? EVENT_BIGFOOD_EATEN : EVENT_FOOD_EATEN;
+        events.eatenX = state.snake.GetBoard().Col(cell) * MYSIZE;
+        events.eatenY = state.snake.GetBoard().Row(cell) * MYSIZE;
+        events.eatenScore = state.foods.ValueAt(eaten);
+        events.eatenKind = kind;
+        Emit(GameEventType::FOOD_EATEN, kind, cell, events.eatenScore);
+        state.timers.Cancel(state.foods.ExpiryAt(eaten));
+        state.foods.Remove(eaten);
+        //吃到普通食物可能凑满bigFoodEvery个，立即检查是否出现大食物；场上没有食物时再补一个
+        if (kind != FOOD_BIG)
+            CheckBigFood(events);
+        SpawnFood();
+    }
+
+    //场上的食物都没了也放不下新的：蛇占满了能放食物的格子，不等下一步撞上自己，本局以获胜结束
+    if (state.foods.Count() == 0)
+    {
+        state.gameover = true;
+        events.flags |= EVENT_BOARD_FULL;
+        Emit(GameEventType::BOARD_FULL, 0, snake.GetHeadCell());
+        return events;
+    }
+
+    if (snake.Defeat())
+    {
+        state.gameover = true;
+        events.flags |= EVENT_DIED;
+        Emit(GameEventType::DIED, snake.HitWall() ? GAME_DEATH_WALL : GAME_DEATH_SELF, snake.GetHeadCell());
+        return events;
+    }
+
+    snake.Move();
+    return events;
+}
+
+template <class B>
+void BasicGameCore<B>::SetRules(const GameRules& rules)
+{
+    nextRules = rules;
+}
+
+template <class B>
+const GameRules& BasicGameCore<B>::GetRules() const
+{
+    return state.rules;
+}
+
+template <class B>
+void BasicGameCore<B>::SetTopology(std::shared_ptr<const BasicTopology<B>> topology)
+{
+    nextTopology = std::move(topology);
+}
+
+template <class B>
+const BasicTopology<B>& BasicGameCore<B>::GetTopology() const
+{
+    return *topology;
+}
+
+template <class B>
+bool BasicGameCore<B>::SetLevel(std::shared_ptr<const LevelMap> level)
+{
+    if (level != nullptr)
+    {
+        const LevelView& view = level->View();
+        const B& board = state.snake.GetBoard();
+        if (std::is_same<B, SparseBoard>::value || !view.Valid()
+            || view.Width() != board.Width() || view.Height() != board.Height())
+            return false;
+    }
+    nextLevel = std::move(level);
+    return true;
+}
+
+template <class B>
+const LevelView* BasicGameCore<B>::GetLevel() const
+{
+    return level != nullptr ? &level->View() : nullptr;
+}
+
+template <class B>
+uint64_t BasicGameCore<B>::GetSeed() const
+{
+    return state.rng.GetSeed();
+}
+
+template <class B>
+void BasicGameCore<B>::SetEventBus(EventBus* bus)
+{
+    this->bus = bus;
+}
+
+template <class B>
+CounterRng& BasicGameCore<B>::EffectRng()
+{
+    return state.rng.effect;
+}
+
+template <class B>
+bool BasicGameCore<B>::IsGameOver() const
+{
+    return state.gameover;
+}
+
+template <class B>
+uint32_t BasicGameCore<B>::GetTick() const
+{
+    return state.tick;
+}
+
+//蛇和食物池各自增量维护，合起来是整个局面的哈希
+template <class B>
+uint64_t BasicGameCore<B>::Hash() const
+{
+    return state.snake.Hash() ^ state.foods.Hash();
+}
+
+template <class B>
+uint64_t BasicGameCore<B>::ComputeHash() const
+{
+    return state.snake.ComputeHash() ^ state.foods.ComputeHash();
+}
+
+template <class B>
+void BasicGameCore<B>::Snapshot(State& out) const
+{
+    if constexpr (std::is_trivially_copyable<State>::value)
+        std::memcpy(&out, &state, sizeof(State));
+    else
+        out = state;
+}
+
+template <class B>
+void BasicGameCore<B>::Restore(const State& in)
+{
+    if constexpr (std::is_trivially_copyable<State>::value)
+        std::memcpy(&state, &in, sizeof(State));
+    else
+        state = in;
+    //快照里的拓扑、墙和可生成食物位图指针可能属于已经释放的一局，改为指向本局持有的
+    const LevelView* view = GetLevel();
+    state.snake.SetTopology(topology.get());
+    state.snake.SetWalls(view != nullptr ? view->WallBits() : nullptr);
+    state.foods.SetEligible(view != nullptr ? view->FoodBits() : nullptr);
+}
+
+template <class B>
+const typename BasicGameCore<B>::SnakeType& BasicGameCore<B>::GetSnake() const
+{
+    return state.snake;
+}
+
+template <class B>
+const BasicFoodPool<B>& BasicGameCore<B>::GetFoods() const
+{
+    return state.foods;
+}
+
+//显式实例化：与snake.cpp中的棋盘列表保持一致
+template struct BasicGameState<TinyBoard>;
+template struct BasicGameState<StandardBoard>;
+template struct BasicGameState<LargeBoard>;
+template struct BasicGameState<DynamicBoard>;
+template struct BasicGameState<SparseBoard>;
+template class BasicGameCore<TinyBoard>;
+template class BasicGameCore<StandardBoard>;
+template class BasicGameCore<LargeBoard>;
+template class BasicGameCore<DynamicBoard>;
+template class BasicGameCore<SparseBoard>;
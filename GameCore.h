@@ -0,0 +1,128 @@
+﻿// GameCore.h - 无界面的游戏核心：棋盘、蛇、食物与规则
+// 只依赖标准库，可在Linux等平台上单独编译，用于服务器模拟、机器人和基准测试
+#pragma once
+#include "snake.h"
+#include "FoodPool.h"
+#include "GameRules.h"
+#include "LevelFile.h"
+#include "InputQueue.h"
+#include "GameRng.h"
+#include "TimerWheel.h"
+#include "EventBus.h"
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+//Step产生的事件，按位组合
+enum StepEventFlags : unsigned
+{
+    EVENT_NONE = 0,
+    EVENT_FOOD_EATEN = 1u << 0,         //吃到普通食物
+    EVENT_BIGFOOD_EATEN = 1u << 1,      //吃到大食物
+    EVENT_BIGFOOD_SPAWNED = 1u << 2,    //大食物出现
+    EVENT_BIGFOOD_EXPIRED = 1u << 3,    //大食物超时消失
+    EVENT_DIED = 1u << 4,               //蛇死亡，本局结束
+    EVENT_TURNED = 1u << 5,             //本帧接受了一次转向
+    EVENT_BOARD_FULL = 1u << 6,         //没有格子能再放食物（蛇占满了棋盘），本局以获胜结束
+};
+
+struct StepEvents
+{
+    unsigned flags;     //StepEventFlags的组合
+    int eatenX;         //被吃食物的位置
+    int eatenY;
+    int eatenScore;     //被吃食物的分数
+    uint8_t eatenKind;  //被吃食物的种类（FoodKind）
+};
+
+//一局游戏的全部状态：小棋盘上只有定长数组和标量，可以直接memcpy
+//搜索型AI和回滚用Snapshot/Restore反复复制它，标准棋盘上约15KB，其中空闲格索引约6.5KB（bench/SnapshotBench打印实际大小）
+template <class B>
+struct BasicGameState
+{
+    GameRng rng;                    //本局的随机数，所有随机量都从这里取
+    GameRules rules;                //本局的规则，开局时从核心复制，局中不变
+    BasicSnake<B> snake;
+    BasicFoodPool<B> foods;         //场上所有食物
+    bool gameover;
+    uint32_t tick;                  //已推进的逻辑帧数，所有计时都以它为准
+    TimerWheel timers;              //按逻辑帧触发的定时事件，限时食物的过期定时器也登记在这里
+
+    explicit BasicGameState(const B& board = B());
+    BasicGameState(uint64_t seed, const B& board);
+};
+
+template <class B>
+class BasicGameCore
+{
+public:
+    using State = BasicGameState<B>;
+    using SnakeType = BasicSnake<B>;
+
+private:
+    State state;
+    GameRules nextRules;            //下一局使用的规则
+    std::shared_ptr<const BasicTopology<B>> topology;       //本局的拓扑，state.snake持有指向它的指针
+    std::shared_ptr<const BasicTopology<B>> nextTopology;   //下一局使用的拓扑
+    std::shared_ptr<const LevelMap> level;                  //本局的关卡，蛇和食物池直接读其中的位图
+    std::shared_ptr<const LevelMap> nextLevel;
+    EventBus* bus;                  //事件的去处，nullptr时不发出事件（对局农场、基准测试）
+
+    void Emit(GameEventType type, uint8_t kind, typename B::Cell cell, int value = 0);
+    int AddFood(uint8_t kind);
+    void SpawnFood();
+    void CheckBigFood(StepEvents& events);
+    void ExpireFood(typename B::Cell cell, StepEvents& events);
+    bool ApplyInput(InputQueue& input);
+
+public:
+    explicit BasicGameCore(uint64_t seed = 0, const B& board = B(), const GameRules& rules = GameRules());
+    void Reset(uint64_t seed);                  //用给定种子开始新的一局；种子、规则和输入相同则整局完全相同
+    void SetRules(const GameRules& rules);      //替换规则，下一次Reset时整体生效，不影响进行中的一局
+    const GameRules& GetRules() const;          //当前这一局的规则
+    //替换拓扑，同样在下一次Reset时生效；拓扑只读，可由多个核心共用
+    //nullptr表示不用查找表、按矩形边界计算（只用于对比测试，此时不能调用GetTopology）
+    void SetTopology(std::shared_ptr<const BasicTopology<B>> topology);
+    const BasicTopology<B>& GetTopology() const;
+    //替换关卡（nullptr为空场地），下一次Reset时生效；关卡尺寸与棋盘不符或棋盘是稀疏棋盘时返回false
+    bool SetLevel(std::shared_ptr<const LevelMap> level);
+    const LevelView* GetLevel() const;          //本局的关卡，没有时为nullptr
+    uint64_t GetSeed() const;
+    CounterRng& EffectRng();                    //供前端特效使用的子流，不影响规则
+    //此后在Reset和Step中把开局、转向、食物出现/被吃/消失和死亡作为GameEvent投递到bus（见EventBus.h）
+    //bus由调用者持有，投递在调用Reset/Step的线程上进行；nullptr为不投递
+    void SetEventBus(EventBus* bus);
+    StepEvents Step(InputQueue& input);         //推进一个逻辑帧，从队列中消耗转向
+    bool IsGameOver() const;
+    uint32_t GetTick() const;
+    //局面的Zobrist哈希：蛇身、蛇头、朝向、待增长和所有食物，不含分数、计时和随机数状态
+    //两个局面哈希相同时（几乎一定）棋盘上的局面相同，供搜索型AI的置换表和回放去重使用
+    uint64_t Hash() const;
+    uint64_t ComputeHash() const;               //不用增量值、从头计算的哈希，用于校验Hash
+
+    void Snapshot(State& out) const;            //保存完整状态
+    //恢复到保存的状态，可按字节复制时为一次memcpy；拓扑、墙和食物位图总是取本局的，
+    //所以快照须来自使用同一拓扑和关卡的一局，但之后换过关卡、旧关卡已释放时也不会访问到它
+    void Restore(const State& in);
+
+    const SnakeType& GetSnake() const;
+    const BasicFoodPool<B>& GetFoods() const;   //场上所有食物
+};
+
+//成员函数定义在GameCore.cpp中，与BasicSnake实例化的棋盘相同
+extern template struct BasicGameState<TinyBoard>;
+extern template struct BasicGameState<StandardBoard>;
+extern template struct BasicGameState<LargeBoard>;
+extern template struct BasicGameState<DynamicBoard>;
+extern template struct BasicGameState<SparseBoard>;
+extern template class BasicGameCore<TinyBoard>;
+extern template class BasicGameCore<StandardBoard>;
+extern template class BasicGameCore<LargeBoard>;
+extern template class BasicGameCore<DynamicBoard>;
+extern template class BasicGameCore<SparseBoard>;
+
+using GameState = BasicGameState<StandardBoard>;
+using GameCore = BasicGameCore<StandardBoard>;
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState必须可按字节复制");
+static_assert(std::is_trivially_copyable<BasicGameState<TinyBoard>>::value, "小棋盘的状态必须可按字节复制");
@@ -0,0 +1,27 @@
+﻿// GameDefs.h - 与平台无关的游戏常量（核心库使用，不依赖图形库和Windows）
+#pragma once
+
+//定义场景大小
+constexpr auto WIDTH = 1040;
+constexpr auto HEIGHT = 640;
+
+//定义食物以及蛇的单位大小
+constexpr auto MYSIZE = 20;
+
+enum class Direction //枚举定义蛇的朝向
+{
+    UP,
+    DOWN,
+    RIGHT,
+    LEFT
+};
+
+//b是否与a正好相反（掉头）：UP/DOWN、RIGHT/LEFT的枚举值只差最低位
+constexpr bool IsReverse(Direction a, Direction b) { return (static_cast<int>(a) ^ 1) == static_cast<int>(b); }
+
+constexpr auto MAXSIZE = 1600; //相当于蛇的最大长度
+constexpr auto SPEED = 150;    //速度
+constexpr auto BIGFOOD_DURATION = 5000; //BigFood显示ms时间
+constexpr auto BIGFOOD_DURATION_TICKS = BIGFOOD_DURATION / SPEED; //BigFood存在的逻辑帧数
+constexpr auto START_LENGTH = 3;   //开局蛇长
+constexpr auto BIGFOOD_EVERY = 4;  //每吃几个食物出现一次BigFood
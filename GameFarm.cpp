@@ -0,0 +1,373 @@
+﻿// GameFarm.cpp - 对局农场实现
+#include "GameFarm.h"
+#include "WorkStealing.h"
+#include "FloodFill.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+FarmConfig::FarmConfig()
+    : games(10000), threads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+    policy(FarmPolicy::RANDOM), script("RRDDLLUU"), seed(1), maxTicks(20000), batch(256), keepRecords(false)
+{
+}
+
+FarmStats::FarmStats()
+    : games(0), ticks(0), totalScore(0), food(0), bigFood(0), minScore(0), maxScore(0), deaths{}, histogram{}
+{
+}
+
+void FarmStats::Add(const FarmRecord& record)
+{
+    minScore = games == 0 ? record.score : std::min(minScore, record.score);
+    maxScore = games == 0 ? record.score : std::max(maxScore, record.score);
+    games++;
+    ticks += record.ticks;
+    totalScore += record.score;
+    food += record.food;
+    bigFood += record.bigFood;
+    deaths[record.cause]++;
+    histogram[std::min(record.score, FARM_SCORE_BUCKETS - 1)]++;
+}
+
+void FarmStats::Merge(const FarmStats& other)
+{
+    if (other.games == 0)
+        return;
+    minScore = games == 0 ? other.minScore : std::min(minScore, other.minScore);
+    maxScore = games == 0 ? other.maxScore : std::max(maxScore, other.maxScore);
+    games += other.games;
+    ticks += other.ticks;
+    totalScore += other.totalScore;
+    food += other.food;
+    bigFood += other.bigFood;
+    for (int i = 0; i < DEATH_CAUSES; i++)
+    {
+        deaths[i] += other.deaths[i];
+    }
+    for (int i = 0; i < FARM_SCORE_BUCKETS; i++)
+    {
+        histogram[i] += other.histogram[i];
+    }
+}
+
+const char* PolicyName(FarmPolicy policy)
+{
+    switch (policy)
+    {
+    case FarmPolicy::SCRIPT:
+        return "script";
+    case FarmPolicy::BOT:
+        return "bot";
+    case FarmPolicy::SAFE:
+        return "safe";
+    default:
+        return "random";
+    }
+}
+
+bool ParsePolicy(const std::string& name, FarmPolicy& policy)
+{
+    if (name == "random")
+        policy = FarmPolicy::RANDOM;
+    else if (name == "script")
+        policy = FarmPolicy::SCRIPT;
+    else if (name == "bot")
+        policy = FarmPolicy::BOT;
+    else if (name == "safe")
+        policy = FarmPolicy::SAFE;
+    else
+        return false;
+    return true;
+}
+
+const char* DeathName(uint8_t cause)
+{
+    switch (cause)
+    {
+    case DEATH_WALL:
+        return "wall";
+    case DEATH_SELF:
+        return "self";
+    case DEATH_BOARD_FULL:
+        return "board_full";
+    default:
+        return "timeout";
+    }
+}
+
+//机器人的目标：分值最高的食物，没有食物时为蛇头自身
+static void BotTarget(const GameCore& core, int& tx, int& ty)
+{
+    const StandardBoard& board = core.GetSnake().GetBoard();
+    const CellIndex head = core.GetSnake().GetHeadCell();
+    tx = board.Col(head);
+    ty = board.Row(head);
+    const FoodPool& foods = core.GetFoods();
+    int bestValue = 0;
+    for (int i = 0; i < foods.Count(); i++)
+    {
+        if (foods.ValueAt(i) > bestValue)
+        {
+            bestValue = foods.ValueAt(i);
+            tx = board.Col(foods.CellAt(i));
+            ty = board.Row(foods.CellAt(i));
+        }
+    }
+}
+
+static const Direction BOT_DIRECTIONS[] = { Direction::UP, Direction::DOWN, Direction::RIGHT, Direction::LEFT };
+
+//贪心机器人：在不掉头的三个方向中选一个安全且离目标最近的
+static Direction BotDirection(const GameCore& core)
+{
+    const Snake& snake = core.GetSnake();
+    const StandardBoard& board = snake.GetBoard();
+    const Direction current = snake.GetDirection();
+    const CellIndex head = snake.GetHeadCell();
+    int tx;
+    int ty;
+    BotTarget(core, tx, ty);
+
+    //下一格查拓扑表，环面、墙和传送门都不需要单独处理
+    const Topology& topology = core.GetTopology();
+    Direction best = current;
+    int bestDistance = -1;
+    for (const Direction dir : BOT_DIRECTIONS)
+    {
+        //UP/DOWN、RIGHT/LEFT的枚举值只差最低位
+        if ((static_cast<int>(dir) ^ static_cast<int>(current)) == 1)
+            continue;
+        const int next = topology.Next(head, dir);
+        if (next == TOPOLOGY_WALL || snake.Blocked(static_cast<CellIndex>(next)))
+            continue;
+        const int distance = std::abs(board.Col(next) - tx) + std::abs(board.Row(next) - ty);
+        if (bestDistance < 0 || distance < bestDistance)
+        {
+            best = dir;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+//谨慎的机器人：走完这一步后，按蛇身逐步让出的时间扩展，能追上现在的尾巴或可达面积不小于蛇长的方向才算安全；
+//在安全的方向中选离目标最近的，都不安全时选可达面积最大的
+//可达区域不跨越环面的边缘和传送门，这类场地上判断偏保守
+static Direction SafeDirection(const GameCore& core, FloodFill& flood)
+{
+    const Snake& snake = core.GetSnake();
+    const StandardBoard& board = snake.GetBoard();
+    const Direction current = snake.GetDirection();
+    const CellIndex head = snake.GetHeadCell();
+    const int length = static_cast<int>(snake.getsize());
+    const int tail = snake.GetCell(static_cast<size_t>(length - 1));
+    int tx;
+    int ty;
+    BotTarget(core, tx, ty);
+
+    const Topology& topology = core.GetTopology();
+    Bitboard passable = ~Bitboard::FromWords(snake.GetOccupancy().Words());
+    passable.AndNot(Bitboard::FromWords(topology.WallMask().Words()));
+    if (core.GetLevel() != nullptr)
+        passable.AndNot(Bitboard::FromWords(core.GetLevel()->WallBits()));
+    flood.ClearReleases();
+    flood.ReleaseSnake(snake, 1);
+
+    Direction best = current;
+    int bestDistance = -1;
+    Direction roomiest = current;
+    int roomiestCells = -1;
+    for (const Direction dir : BOT_DIRECTIONS)
+    {
+        if ((static_cast<int>(dir) ^ static_cast<int>(current)) == 1)
+            continue;
+        const int next = topology.Next(head, dir);
+        if (next == TOPOLOGY_WALL || snake.Blocked(static_cast<CellIndex>(next)))
+            continue;
+        Bitboard start;
+        start.Set(next);
+        const FloodResult reach = flood.Run(start, passable, tail, true);
+        if (reach.cells > roomiestCells)
+        {
+            roomiest = dir;
+            roomiestCells = reach.cells;
+        }
+        if (reach.targetStep < 0 && reach.cells < length)
+            continue;
+        const int distance = std::abs(board.Col(next) - tx) + std::abs(board.Row(next) - ty);
+        if (bestDistance < 0 || distance < bestDistance)
+        {
+            best = dir;
+            bestDistance = distance;
+        }
+    }
+    return bestDistance >= 0 ? best : roomiest;
+}
+
+//跑完第index局，core和input由所在线程复用
+static FarmRecord PlayGame(const FarmConfig& config, long long index, GameCore& core, InputQueue& input)
+{
+    const uint64_t gameSeed = RngMix(config.seed ^ RngMix(static_cast<uint64_t>(index)));
+    core.Reset(gameSeed);
+    input.Clear();
+    CounterRng policyRng(gameSeed, static_cast<uint64_t>(RngStream::EFFECT));
+    FloodFill flood;
+
+    FarmRecord record{};
+    record.cause = DEATH_TIMEOUT;
+    for (int t = 0; t < config.maxTicks; t++)
+    {
+        switch (config.policy)
+        {
+        case FarmPolicy::RANDOM:
+            if (policyRng.Below(8) == 0)
+                input.Push({ t, static_cast<Direction>(policyRng.Below(4)) });
+            break;
+        case FarmPolicy::SCRIPT:
+            if (!config.script.empty())
+            {
+                switch (config.script[t % config.script.size()])
+                {
+                case 'U':
+                    input.Push({ t, Direction::UP });
+                    break;
+                case 'D':
+                    input.Push({ t, Direction::DOWN });
+                    break;
+                case 'L':
+                    input.Push({ t, Direction::LEFT });
+                    break;
+                case 'R':
+                    input.Push({ t, Direction::RIGHT });
+                    break;
+                }
+            }
+            break;
+        case FarmPolicy::BOT:
+            input.Push({ t, BotDirection(core) });
+            break;
+        case FarmPolicy::SAFE:
+            input.Push({ t, SafeDirection(core, flood) });
+            break;
+        }
+
+        const StepEvents events = core.Step(input);
+        record.ticks++;
+        if (events.flags & EVENT_FOOD_EATEN)
+            record.food++;
+        if (events.flags & EVENT_BIGFOOD_EATEN)
+            record.bigFood++;
+        if (events.flags & EVENT_DIED)
+        {
+            record.cause = core.GetSnake().HitWall() ? DEATH_WALL : DEATH_SELF;
+            break;
+        }
+        if (events.flags & EVENT_BOARD_FULL)
+        {
+            record.cause = DEATH_BOARD_FULL;
+            break;
+        }
+    }
+    record.score = core.GetSnake().GetScore();
+    record.length = static_cast<int>(core.GetSnake().getsize());
+    return record;
+}
+
+//每个线程独占一份，按缓存行对齐避免伪共享
+struct alignas(64) FarmWorker
+{
+    std::unique_ptr<GameCore> core;
+    InputQueue input;
+    FarmStats stats;
+};
+
+FarmResult RunFarm(const FarmConfig& config)
+{
+    using Clock = std::chrono::steady_clock;
+
+    FarmResult result;
+    const int batch = std::max(1, config.batch);
+    const int tasks = static_cast<int>((config.games + batch - 1) / batch);
+    if (config.keepRecords)
+        result.records.resize(static_cast<size_t>(config.games));
+
+    WorkStealingScheduler scheduler(config.threads);
+    std::vector<FarmWorker> workers(scheduler.Threads());
+    for (FarmWorker& w : workers)
+    {
+        w.core = std::make_unique<GameCore>(0, StandardBoard(), config.rules);
+        w.core->SetLevel(config.level);     //尺寸已在命令行中检查，所有线程共用同一份映射
+    }
+
+    const auto start = Clock::now();
+    scheduler.Run(tasks, [&](int worker, int task)
+    {
+        FarmWorker& w = workers[worker];
+        const long long begin = static_cast<long long>(task) * batch;
+        const long long end = std::min(config.games, begin + batch);
+        for (long long g = begin; g < end; g++)
+        {
+            const FarmRecord record = PlayGame(config, g, *w.core, w.input);
+            w.stats.Add(record);
+            if (config.keepRecords)
+                result.records[static_cast<size_t>(g)] = record;    //每局写自己的槽位，无需加锁
+        }
+    });
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.steals = scheduler.Steals();
+
+    //所有线程已结束，按线程编号顺序合并；各项都是求和或取极值，结果与调度无关
+    for (const FarmWorker& w : workers)
+    {
+        result.stats.Merge(w.stats);
+    }
+    return result;
+}
+
+void WriteFarmJson(std::ostream& out, const FarmConfig& config, const FarmResult& result)
+{
+    const FarmStats& s = result.stats;
+    out << "{\n";
+    out << "  \"games\": " << s.games << ",\n";
+    out << "  \"threads\": " << config.threads << ",\n";
+    out << "  \"policy\": \"" << PolicyName(config.policy) << "\",\n";
+    out << "  \"seed\": " << config.seed << ",\n";
+    out << "  \"max_ticks\": " << config.maxTicks << ",\n";
+    out << "  \"rules\": { \"tick_period\": " << config.rules.tickPeriod
+        << ", \"initial_length\": " << config.rules.initialLength
+        << ", \"max_length\": " << config.rules.maxLength
+        << ", \"big_food_every\": " << config.rules.bigFoodEvery
+        << ", \"big_food_score\": " << config.rules.foodScore[FOOD_BIG] << " },\n";
+    out << "  \"seconds\": " << result.seconds << ",\n";
+    out << "  \"games_per_second\": " << (result.seconds > 0 ? s.games / result.seconds : 0.0) << ",\n";
+    out << "  \"ticks\": " << s.ticks << ",\n";
+    out << "  \"steals\": " << result.steals << ",\n";
+    out << "  \"score\": {\n";
+    out << "    \"mean\": " << (s.games ? static_cast<double>(s.totalScore) / s.games : 0.0) << ",\n";
+    out << "    \"min\": " << s.minScore << ",\n";
+    out << "    \"max\": " << s.maxScore << ",\n";
+    //直方图去掉末尾的空桶；最后一桶是"不低于该分数"
+    int last = FARM_SCORE_BUCKETS - 1;
+    while (last > 0 && s.histogram[last] == 0)
+    {
+        last--;
+    }
+    out << "    \"histogram\": [";
+    for (int i = 0; i <= last; i++)
+    {
+        out << (i ? ", " : "") << s.histogram[i];
+    }
+    out << "]\n";
+    out << "  },\n";
+    out << "  \"food_eaten\": " << s.food << ",\n";
+    out << "  \"big_food_eaten\": " << s.bigFood << ",\n";
+    out << "  \"deaths\": {";
+    for (int i = 0; i < DEATH_CAUSES; i++)
+    {
+        out << (i ? ", " : " ") << "\"" << DeathName(static_cast<uint8_t>(i)) << "\": " << s.deaths[i];
+    }
+    out << " }\n";
+    out << "}\n";
+}
@@ -0,0 +1,90 @@
+﻿// GameFarm.h - 无界面对局农场：在所有核心上跑大量对局并汇总统计
+// 对局按批交给工作窃取调度器；每局的种子只由总种子和局号决定，结果与线程数和调度顺序无关
+#pragma once
+#include "GameCore.h"
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//操控蛇的方式
+enum class FarmPolicy
+{
+    RANDOM,     //每帧以1/8的概率随机转向
+    SCRIPT,     //按脚本字符串（U/D/L/R）逐帧循环给出方向
+    BOT,        //贪心机器人：朝食物走，避开边界和蛇身
+    SAFE,       //谨慎的机器人：同BOT，但不走进追不上尾巴的死路（见FloodFill.h）
+};
+
+struct FarmConfig
+{
+    long long games;
+    int threads;
+    FarmPolicy policy;
+    std::string script;
+    uint64_t seed;
+    int maxTicks;       //单局最多推进的逻辑帧数，超过记为超时
+    int batch;          //每个调度任务包含的局数
+    bool keepRecords;   //是否保留每局结果（写数据库时需要）
+    GameRules rules;    //所有对局共用的规则
+    std::shared_ptr<const LevelMap> level;  //所有对局共用的关卡，nullptr为空场地
+
+    FarmConfig();
+};
+
+//结束原因
+enum FarmDeath : uint8_t
+{
+    DEATH_WALL,
+    DEATH_SELF,
+    DEATH_TIMEOUT,
+    DEATH_BOARD_FULL,   //蛇占满了棋盘，以获胜结束
+    DEATH_CAUSES,
+};
+
+constexpr int FARM_SCORE_BUCKETS = 256;    //分数直方图每分一桶，最后一桶包含更高的分数
+
+//单局结果，对应game_records的一行
+struct FarmRecord
+{
+    int score;
+    int length;
+    int food;
+    int bigFood;
+    int ticks;
+    uint8_t cause;      //FarmDeath
+};
+
+//汇总统计：各线程各自累加，全部结束后合并
+struct FarmStats
+{
+    long long games;
+    long long ticks;
+    long long totalScore;
+    long long food;
+    long long bigFood;
+    int minScore;
+    int maxScore;
+    long long deaths[DEATH_CAUSES];
+    long long histogram[FARM_SCORE_BUCKETS];
+
+    FarmStats();
+    void Add(const FarmRecord& record);
+    void Merge(const FarmStats& other);
+};
+
+struct FarmResult
+{
+    FarmStats stats;
+    std::vector<FarmRecord> records;    //按局号排列，只在keepRecords时填充
+    double seconds;
+    long long steals;
+};
+
+const char* PolicyName(FarmPolicy policy);
+bool ParsePolicy(const std::string& name, FarmPolicy& policy);
+const char* DeathName(uint8_t cause);
+
+FarmResult RunFarm(const FarmConfig& config);
+void WriteFarmJson(std::ostream& out, const FarmConfig& config, const FarmResult& result);
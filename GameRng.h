@@ -0,0 +1,95 @@
+﻿// GameRng.h - 计数器型随机数：每局游戏一个64位种子，按用途划分互不相关的子流
+// 第n个输出只由(种子, 子流, n)决定，不依赖标准库分布的实现，因此跨线程、跨平台结果一致
+#pragma once
+#include <cstdint>
+
+//SplitMix64的混合函数，把任意64位输入打散为均匀的64位输出
+inline uint64_t RngMix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+//单个子流：输出 = RngMix(key + counter * 黄金比例常数)
+class CounterRng
+{
+private:
+    uint64_t key;
+    uint64_t counter;
+
+public:
+    CounterRng() : key(0), counter(0) {}
+    CounterRng(uint64_t seed, uint64_t stream) { Seed(seed, stream); }
+
+    void Seed(uint64_t seed, uint64_t stream)
+    {
+        key = RngMix(seed ^ RngMix(stream + 0x9E3779B97F4A7C15ull));
+        counter = 0;
+    }
+
+    //第n个输出，不改变状态
+    uint64_t At(uint64_t n) const { return RngMix(key + n * 0x9E3779B97F4A7C15ull); }
+
+    uint64_t Next() { return At(counter++); }
+    uint64_t GetCounter() const { return counter; }
+
+    //[0, n)内均匀分布的整数（Lemire乘法取高位并拒绝偏差部分），n为0时返回0
+    uint32_t Below(uint32_t n)
+    {
+        if (n == 0)
+            return 0;
+        uint64_t m = (Next() >> 32) * n;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < n)
+        {
+            const uint32_t threshold = (0u - n) % n;
+            while (low < threshold)
+            {
+                m = (Next() >> 32) * n;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+
+    //[lo, hi]内均匀分布的整数
+    int Range(int lo, int hi)
+    {
+        return lo + static_cast<int>(Below(static_cast<uint32_t>(hi - lo + 1)));
+    }
+};
+
+//子流编号
+enum class RngStream : uint64_t
+{
+    FOOD = 1,       //食物位置
+    COLOR = 2,      //蛇身颜色
+    EFFECT = 3,     //特效等不影响规则的随机量
+    SPAWN = 4,      //竞技场中蛇的出生位置
+    LEVEL = 5,      //程序生成关卡的候选布局（低32位为候选序号）
+};
+
+//每局游戏持有一份，由同一个种子派生各子流
+class GameRng
+{
+private:
+    uint64_t seed;
+
+public:
+    CounterRng food;
+    CounterRng color;
+    CounterRng effect;
+
+    explicit GameRng(uint64_t seed = 0) { Reseed(seed); }
+
+    void Reseed(uint64_t newSeed)
+    {
+        seed = newSeed;
+        food.Seed(seed, static_cast<uint64_t>(RngStream::FOOD));
+        color.Seed(seed, static_cast<uint64_t>(RngStream::COLOR));
+        effect.Seed(seed, static_cast<uint64_t>(RngStream::EFFECT));
+    }
+
+    uint64_t GetSeed() const { return seed; }
+};
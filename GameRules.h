@@ -0,0 +1,50 @@
+﻿// GameRules.h - 一局游戏的规则参数
+// 前端在两局之间从system_config读入（见AdvancedSQLiteDB::loadGameRules），整体复制进核心，
+// 下一局开始时生效；逻辑帧中只读这个扁平结构，不会访问数据库
+#pragma once
+#include "GameDefs.h"
+#include "FoodPool.h"
+
+struct GameRules
+{
+    int tickPeriod;                 //GAME_SPEED：逻辑帧周期（毫秒）
+    int initialLength;              //INITIAL_LENGTH：开局蛇长
+    int maxLength;                  //MAX_LENGTH：蛇身最大节数，0表示只受棋盘大小限制
+    int bigFoodEvery;               //BIG_FOOD_SPAWN：每吃几个食物出现一次大食物，0表示不出现
+    int foodScore[FOOD_KINDS];      //各种食物的分值，BIG_FOOD_SCORE对应FOOD_BIG
+    int foodLifetime[FOOD_KINDS];   //各种食物存在的逻辑帧数，0表示不会过期
+
+    //默认值即数据库不可用时游戏原本使用的常量
+    GameRules() : tickPeriod(SPEED), initialLength(START_LENGTH), maxLength(0), bigFoodEvery(BIGFOOD_EVERY)
+    {
+        for (int k = 0; k < FOOD_KINDS; k++)
+            foodScore[k] = FOOD_TYPES[k].score;
+        SetTickPeriod(SPEED);
+    }
+
+    //食物的存在时间以毫秒为准，帧周期变化时重新换算成帧数
+    void SetTickPeriod(int period)
+    {
+        tickPeriod = period > 0 ? period : SPEED;
+        for (int k = 0; k < FOOD_KINDS; k++)
+        {
+            const int ticks = FOOD_TYPES[k].lifetime / tickPeriod;
+            foodLifetime[k] = FOOD_TYPES[k].lifetime > 0 && ticks == 0 ? 1 : ticks;   //限时食物至少存在一帧
+        }
+    }
+
+    bool operator==(const GameRules& other) const
+    {
+        if (tickPeriod != other.tickPeriod || initialLength != other.initialLength
+            || maxLength != other.maxLength || bigFoodEvery != other.bigFoodEvery)
+            return false;
+        for (int k = 0; k < FOOD_KINDS; k++)
+        {
+            if (foodScore[k] != other.foodScore[k] || foodLifetime[k] != other.foodLifetime[k])
+                return false;
+        }
+        return true;
+    }
+
+    bool operator!=(const GameRules& other) const { return !(*this == other); }
+};
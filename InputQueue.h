@@ -0,0 +1,25 @@
+﻿// InputQueue.h - 带时间戳的转向输入队列
+// 键盘采样、录像回放或机器人都往同一个队列写入，核心每个逻辑帧从中取有限条转向
+#pragma once
+#include "GameDefs.h"
+#include "SpscRing.h"
+#include <chrono>
+#include <cstdint>
+
+struct InputEvent
+{
+    int64_t time;       //单调时钟时间戳（微秒），合成输入可填逻辑帧号等任意递增值
+    Direction dir;      //请求的方向
+};
+
+constexpr size_t INPUT_QUEUE_SIZE = 16;    //队列容量
+constexpr int MAX_INPUTS_PER_TICK = 4;     //每个逻辑帧最多检查的输入条数
+
+using InputQueue = SpscRing<InputEvent, INPUT_QUEUE_SIZE>;
+
+//当前单调时钟时间（微秒）
+inline int64_t MonotonicMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,333 @@
+﻿// LevelFile.cpp - 二进制关卡的编码、文本转换和文件映射
+#include "LevelFile.h"
+#include "Topology.h"
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char LEVEL_MAGIC[4] = { 'S', 'N', 'L', 'V' };
+
+static uint32_t AlignUp(uint32_t n)
+{
+    return (n + LEVEL_ALIGN - 1) / LEVEL_ALIGN * LEVEL_ALIGN;
+}
+
+bool LevelView::Attach(const void* data, size_t size)
+{
+    header = nullptr;
+    if (data == nullptr || size < sizeof(LevelHeader) || reinterpret_cast<uintptr_t>(data) % 8 != 0)
+        return false;
+
+    const LevelHeader* h = static_cast<const LevelHeader*>(data);
+    if (std::memcmp(h->magic, LEVEL_MAGIC, 4) != 0 || h->version != LEVEL_VERSION || h->headerSize != sizeof(LevelHeader))
+        return false;
+    if (h->width == 0 || h->height == 0 || h->width > LEVEL_MAX_SIDE || h->height > LEVEL_MAX_SIDE)
+        return false;
+    if (h->words != (static_cast<uint32_t>(h->width) * h->height + 63) / 64 || h->spawnCount > LEVEL_MAX_SPAWNS)
+        return false;
+    if (h->fileSize != size || h->name[LEVEL_NAME_SIZE - 1] != '\0')
+        return false;
+
+    //各段需对齐且完整地落在文件内
+    const uint64_t bitmapBytes = static_cast<uint64_t>(h->words) * 8;
+    const uint64_t spawnBytes = static_cast<uint64_t>(h->spawnCount) * sizeof(LevelSpawn);
+    if (h->wallsOffset % 8 || h->foodOffset % 8 || h->spawnsOffset % 8)
+        return false;
+    if (h->wallsOffset < sizeof(LevelHeader) || h->wallsOffset + bitmapBytes > size
+        || h->foodOffset < sizeof(LevelHeader) || h->foodOffset + bitmapBytes > size
+        || h->spawnsOffset < sizeof(LevelHeader) || h->spawnsOffset + spawnBytes > size)
+        return false;
+
+    const uint8_t* base = static_cast<const uint8_t*>(data);
+    walls = reinterpret_cast<const uint64_t*>(base + h->wallsOffset);
+    food = reinterpret_cast<const uint64_t*>(base + h->foodOffset);
+    spawns = reinterpret_cast<const LevelSpawn*>(base + h->spawnsOffset);
+
+    //引擎原地使用这两张位图：可生成食物的格子不能是墙，最后一个字中棋盘以外的位必须为0
+    const uint32_t cells = static_cast<uint32_t>(h->width) * h->height;
+    const uint64_t lastMask = cells % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (cells % 64)) - 1;
+    for (uint32_t i = 0; i < h->words; i++)
+    {
+        if (walls[i] & food[i])
+            return false;
+    }
+    if ((walls[h->words - 1] | food[h->words - 1]) & ~lastMask)
+        return false;
+
+    //出生点的蛇头和默认长度的蛇身（向朝向的反方向排开，到边界为止）都不能在墙上，否则蛇一出生就撞墙
+    for (int i = 0; i < h->spawnCount; i++)
+    {
+        const LevelSpawn& s = spawns[i];
+        if (s.x >= h->width || s.y >= h->height || s.dir > static_cast<uint8_t>(Direction::LEFT))
+            return false;
+        const int bx = -TOPOLOGY_DX[s.dir];
+        const int by = -TOPOLOGY_DY[s.dir];
+        for (int k = 0; k < START_LENGTH; k++)
+        {
+            const int x = s.x + bx * k;
+            const int y = s.y + by * k;
+            if (x < 0 || x >= h->width || y < 0 || y >= h->height)
+                break;
+            if (Test(walls, y * h->width + x))
+                return false;
+        }
+    }
+    header = h;
+    return true;
+}
+
+LevelData::LevelData(int width, int height) : width(width), height(height)
+{
+    walls.assign(Words(), 0);
+    food.assign(Words(), 0);
+}
+
+void LevelData::SetWall(int x, int y, bool wall)
+{
+    const int cell = y * width + x;
+    if (wall)
+        walls[cell >> 6] |= uint64_t(1) << (cell & 63);
+    else
+        walls[cell >> 6] &= ~(uint64_t(1) << (cell & 63));
+}
+
+void LevelData::SetFood(int x, int y, bool allowed)
+{
+    const int cell = y * width + x;
+    if (allowed)
+        food[cell >> 6] |= uint64_t(1) << (cell & 63);
+    else
+        food[cell >> 6] &= ~(uint64_t(1) << (cell & 63));
+}
+
+bool LevelData::IsWall(int x, int y) const
+{
+    const int cell = y * width + x;
+    return (walls[cell >> 6] >> (cell & 63)) & 1;
+}
+
+bool LevelData::CanFood(int x, int y) const
+{
+    const int cell = y * width + x;
+    return (food[cell >> 6] >> (cell & 63)) & 1;
+}
+
+void LevelData::AddSpawn(int x, int y, Direction dir)
+{
+    LevelSpawn spawn{};
+    spawn.x = static_cast<uint16_t>(x);
+    spawn.y = static_cast<uint16_t>(y);
+    spawn.dir = static_cast<uint8_t>(dir);
+    spawns.push_back(spawn);
+}
+
+std::vector<uint8_t> EncodeLevel(const LevelData& level)
+{
+    LevelHeader h{};
+    std::memcpy(h.magic, LEVEL_MAGIC, 4);
+    h.version = LEVEL_VERSION;
+    h.headerSize = sizeof(LevelHeader);
+    h.width = static_cast<uint16_t>(level.width);
+    h.height = static_cast<uint16_t>(level.height);
+    h.spawnCount = static_cast<uint16_t>(level.spawns.size() < LEVEL_MAX_SPAWNS ? level.spawns.size() : LEVEL_MAX_SPAWNS);
+    h.words = static_cast<uint32_t>(level.Words());
+    h.wallsOffset = AlignUp(sizeof(LevelHeader));
+    h.foodOffset = AlignUp(h.wallsOffset + h.words * 8);
+    h.spawnsOffset = AlignUp(h.foodOffset + h.words * 8);
+    h.fileSize = h.spawnsOffset + h.spawnCount * static_cast<uint32_t>(sizeof(LevelSpawn));
+    std::strncpy(h.name, level.name.c_str(), LEVEL_NAME_SIZE - 1);
+
+    //墙格上不生成食物，与文本中的标记无关
+    std::vector<uint64_t> food(level.food);
+    for (size_t i = 0; i < food.size(); i++)
+    {
+        food[i] &= ~level.walls[i];
+    }
+
+    std::vector<uint8_t> bytes(h.fileSize, 0);
+    std::memcpy(&bytes[0], &h, sizeof(h));
+    std::memcpy(&bytes[h.wallsOffset], level.walls.data(), h.words * 8);
+    std::memcpy(&bytes[h.foodOffset], food.data(), h.words * 8);
+    if (h.spawnCount > 0)
+        std::memcpy(&bytes[h.spawnsOffset], level.spawns.data(), h.spawnCount * sizeof(LevelSpawn));
+    return bytes;
+}
+
+bool ParseLevelText(std::istream& in, LevelData& level, std::string& error)
+{
+    std::string name;
+    std::vector<std::string> rows;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line.compare(0, 2, "//") == 0)
+            continue;
+        if (line.compare(0, 5, "name:") == 0)
+        {
+            name = line.substr(5);
+            name.erase(0, name.find_first_not_of(' '));
+            continue;
+        }
+        if (!rows.empty() && line.size() != rows[0].size())
+        {
+            error = "第" + std::to_string(rows.size() + 1) + "行的长度与第1行不同";
+            return false;
+        }
+        rows.push_back(line);
+    }
+    if (rows.empty())
+    {
+        error = "没有格子";
+        return false;
+    }
+    if (rows[0].size() > LEVEL_MAX_SIDE || rows.size() > LEVEL_MAX_SIDE)
+    {
+        error = "关卡过大";
+        return false;
+    }
+
+    level = LevelData(static_cast<int>(rows[0].size()), static_cast<int>(rows.size()));
+    level.name = name;
+    for (int y = 0; y < level.height; y++)
+    {
+        for (int x = 0; x < level.width; x++)
+        {
+            switch (rows[y][x])
+            {
+            case '#':
+                level.SetWall(x, y, true);
+                break;
+            case '.':
+                level.SetFood(x, y, true);
+                break;
+            case ',':
+                break;
+            case '^':
+                level.AddSpawn(x, y, Direction::UP);
+                break;
+            case 'v':
+                level.AddSpawn(x, y, Direction::DOWN);
+                break;
+            case '<':
+                level.AddSpawn(x, y, Direction::LEFT);
+                break;
+            case '>':
+                level.AddSpawn(x, y, Direction::RIGHT);
+                break;
+            default:
+                error = "第" + std::to_string(y + 1) + "行有未知字符'" + rows[y][x] + "'";
+                return false;
+            }
+        }
+    }
+    if (level.spawns.size() > LEVEL_MAX_SPAWNS)
+    {
+        error = "出生点超过" + std::to_string(LEVEL_MAX_SPAWNS) + "个";
+        return false;
+    }
+    return true;
+}
+
+LevelMap::LevelMap() : data(nullptr), size(0)
+#ifdef _WIN32
+, file(INVALID_HANDLE_VALUE), mapping(nullptr)
+#endif
+{
+}
+
+LevelMap::~LevelMap()
+{
+    Close();
+}
+
+void LevelMap::Close()
+{
+    view = LevelView();
+#ifdef _WIN32
+    if (data != nullptr && buffer.empty())
+        UnmapViewOfFile(data);
+    if (mapping != nullptr)
+        CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+#else
+    if (data != nullptr && buffer.empty())
+        munmap(const_cast<void*>(data), size);
+#endif
+    buffer.clear();
+    data = nullptr;
+    size = 0;
+}
+
+bool LevelMap::Open(const std::string& path)
+{
+    Close();
+#ifdef _WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    //映射建立后即可关闭文件描述符
+    if (mapped == MAP_FAILED)
+        return false;
+    data = mapped;
+    size = static_cast<size_t>(st.st_size);
+#endif
+    if (data == nullptr || !view.Attach(data, size))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool LevelMap::Adopt(const std::vector<uint8_t>& bytes)
+{
+    Close();
+    if (bytes.empty())
+        return false;
+    buffer.assign((bytes.size() + 7) / 8, 0);
+    std::memcpy(buffer.data(), bytes.data(), bytes.size());
+    data = buffer.data();
+    size = bytes.size();
+    if (!view.Attach(data, size))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,137 @@
+﻿// LevelFile.h - 二进制关卡格式
+// 定长布局（小端）：64字节文件头，随后依次是墙位图、可生成食物的位图和出生点表，各段按64字节对齐
+// 引擎把文件mmap进来后原地使用，碰撞和食物生成直接读映射中的位图，切换关卡不需要解析或复制
+// 文本关卡用tools/LevelConvert转换成这种格式
+#pragma once
+#include "Board.h"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+constexpr uint16_t LEVEL_VERSION = 1;
+constexpr int LEVEL_ALIGN = 64;         //各段的对齐字节数
+constexpr int LEVEL_MAX_SPAWNS = 64;
+constexpr int LEVEL_NAME_SIZE = 24;
+constexpr int LEVEL_MAX_SIDE = 4096;    //关卡的最大边长
+
+//文件头，字段顺序和大小固定；修改布局时必须增加LEVEL_VERSION
+struct LevelHeader
+{
+    char magic[4];          //"SNLV"
+    uint16_t version;
+    uint16_t headerSize;    //sizeof(LevelHeader)
+    uint16_t width;
+    uint16_t height;
+    uint16_t spawnCount;
+    uint16_t flags;         //保留，目前为0
+    uint32_t words;         //每张位图的uint64_t个数
+    uint32_t wallsOffset;   //各段相对文件开头的字节偏移
+    uint32_t foodOffset;
+    uint32_t spawnsOffset;
+    uint32_t fileSize;
+    uint32_t reserved;
+    char name[LEVEL_NAME_SIZE]; //以0结尾
+};
+
+//出生点：蛇头所在格和初始朝向，蛇身向朝向的反方向排开
+struct LevelSpawn
+{
+    uint16_t x;
+    uint16_t y;
+    uint8_t dir;            //Direction
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(LevelHeader) == 64, "LevelHeader的布局是文件格式的一部分");
+static_assert(sizeof(LevelSpawn) == 8, "LevelSpawn的布局是文件格式的一部分");
+
+//关卡数据的只读视图，指向映射的文件或内存缓冲区，本身不拥有数据
+//格子编号与稠密棋盘相同：y * width + x
+class LevelView
+{
+private:
+    const LevelHeader* header;
+    const uint64_t* walls;
+    const uint64_t* food;
+    const LevelSpawn* spawns;
+
+    static bool Test(const uint64_t* bits, int cell) { return (bits[cell >> 6] >> (cell & 63)) & 1; }
+
+public:
+    LevelView() : header(nullptr), walls(nullptr), food(nullptr), spawns(nullptr) {}
+
+    //校验文件头和各段的范围后指向data；data需按8字节对齐并在视图使用期间有效
+    bool Attach(const void* data, size_t size);
+
+    bool Valid() const { return header != nullptr; }
+    int Width() const { return header->width; }
+    int Height() const { return header->height; }
+    int Words() const { return static_cast<int>(header->words); }
+    const char* Name() const { return header->name; }
+
+    bool IsWall(int cell) const { return Test(walls, cell); }
+    bool CanFood(int cell) const { return Test(food, cell); }
+    bool IsWallAt(int x, int y) const { return IsWall(y * header->width + x); }
+    bool CanFoodAt(int x, int y) const { return CanFood(y * header->width + x); }
+    const uint64_t* WallBits() const { return walls; }
+    const uint64_t* FoodBits() const { return food; }
+
+    int SpawnCount() const { return header->spawnCount; }
+    const LevelSpawn& Spawn(int i) const { return spawns[i]; }
+};
+
+//可编辑的关卡，用于文本转换和程序生成，EncodeLevel后得到文件内容
+struct LevelData
+{
+    std::string name;
+    int width;
+    int height;
+    std::vector<uint64_t> walls;
+    std::vector<uint64_t> food;
+    std::vector<LevelSpawn> spawns;
+
+    explicit LevelData(int width = GRID_WIDTH, int height = GRID_HEIGHT);
+
+    int Words() const { return (width * height + 63) / 64; }
+    void SetWall(int x, int y, bool wall);
+    void SetFood(int x, int y, bool allowed);
+    bool IsWall(int x, int y) const;
+    bool CanFood(int x, int y) const;
+    void AddSpawn(int x, int y, Direction dir);
+};
+
+std::vector<uint8_t> EncodeLevel(const LevelData& level);
+
+//文本格式：每行一排格子，所有行等长
+//  '#' 墙   '.' 空地（可生成食物）   ',' 空地（不生成食物）   '^' 'v' '<' '>' 出生点（蛇头朝向）
+//以"name:"开头的行给出关卡名，以"//"开头的行和空行忽略
+bool ParseLevelText(std::istream& in, LevelData& level, std::string& error);
+
+//关卡文件的映射：Open把文件只读映射进内存，Adopt接管一段内存中的关卡（如程序生成的关卡）
+//不可复制；GameCore等通过shared_ptr共用
+class LevelMap
+{
+private:
+    const void* data;
+    size_t size;
+    std::vector<uint64_t> buffer;   //Adopt时的存储，保证8字节对齐
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#endif
+    LevelView view;
+
+    void Close();
+
+public:
+    LevelMap();
+    ~LevelMap();
+    LevelMap(const LevelMap&) = delete;
+    LevelMap& operator=(const LevelMap&) = delete;
+
+    bool Open(const std::string& path);
+    bool Adopt(const std::vector<uint8_t>& bytes);
+    const LevelView& View() const { return view; }
+};
@@ -0,0 +1,254 @@
+﻿// LevelGen.cpp - 程序生成关卡实现
+#include "LevelGen.h"
+#include "Topology.h"
+#include <atomic>
+#include <bitset>
+#include <cstdio>
+#include <stdexcept>
+
+//行内向低位方向的遮挡填充：seed沿free中连续的位一直扩展（Kogge-Stone，6步覆盖64位）
+static uint64_t FillLow(uint64_t seed, uint64_t free)
+{
+    seed |= free & (seed >> 1);
+    free &= free >> 1;
+    seed |= free & (seed >> 2);
+    free &= free >> 2;
+    seed |= free & (seed >> 4);
+    free &= free >> 4;
+    seed |= free & (seed >> 8);
+    free &= free >> 8;
+    seed |= free & (seed >> 16);
+    free &= free >> 16;
+    seed |= free & (seed >> 32);
+    return seed;
+}
+
+//同上，向高位方向
+static uint64_t FillHigh(uint64_t seed, uint64_t free)
+{
+    seed |= free & (seed << 1);
+    free &= free << 1;
+    seed |= free & (seed << 2);
+    free &= free << 2;
+    seed |= free & (seed << 4);
+    free &= free << 4;
+    seed |= free & (seed << 8);
+    free &= free << 8;
+    seed |= free & (seed << 16);
+    free &= free << 16;
+    seed |= free & (seed << 32);
+    return seed;
+}
+
+//一行内的连通段：seed所在的整段空地
+static uint64_t FillRow(uint64_t seed, uint64_t free)
+{
+    seed &= free;
+    return FillLow(seed, free) | FillHigh(seed, free);
+}
+
+//每行先在行内填满整段，再向下、向上各扫一遍把到达的格子传给相邻行，直到不再变化
+//每一遍都把整行一次扩展完，通常两三遍就收敛，远少于逐格BFS的步数
+void FloodRows(const LevelRows& free, const LevelRows& seed, int height, LevelRows& reach)
+{
+    for (int y = 0; y < height; y++)
+    {
+        reach.rows[y] = FillRow(seed.rows[y], free.rows[y]);
+    }
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int y = 1; y < height; y++)
+        {
+            const uint64_t grown = FillRow(reach.rows[y] | reach.rows[y - 1], free.rows[y]);
+            changed |= grown != reach.rows[y];
+            reach.rows[y] = grown;
+        }
+        for (int y = height - 2; y >= 0; y--)
+        {
+            const uint64_t grown = FillRow(reach.rows[y] | reach.rows[y + 1], free.rows[y]);
+            changed |= grown != reach.rows[y];
+            reach.rows[y] = grown;
+        }
+    }
+}
+
+LevelGenerator::LevelGenerator(const LevelGenConfig& config) : config(config), spawnCells{}
+{
+    if (config.width < 1 || config.width > LEVELGEN_MAX_SIDE || config.height < 1 || config.height > LEVELGEN_MAX_SIDE)
+        throw std::invalid_argument("程序生成的关卡宽高需在1~64之间");
+    const int dx = TOPOLOGY_DX[static_cast<int>(config.spawnDir)];
+    const int dy = TOPOLOGY_DY[static_cast<int>(config.spawnDir)];
+    rowMask = config.width == 64 ? ~uint64_t(0) : (uint64_t(1) << config.width) - 1;
+
+    //出生通道：蛇头身后spawnLength-1格和前方corridor格，超出场地的部分忽略
+    for (int i = -(config.spawnLength - 1); i <= config.corridor; i++)
+    {
+        const int gx = config.spawnX + dx * i;
+        const int gy = config.spawnY + dy * i;
+        if (gx >= 0 && gx < config.width && gy >= 0 && gy < config.height)
+            spawnCells.rows[gy] |= uint64_t(1) << gx;
+        else if (i == 0)
+            throw std::invalid_argument("出生点不在场地内");
+    }
+}
+
+const LevelGenConfig& LevelGenerator::Config() const
+{
+    return config;
+}
+
+//随机放置横竖条和小方块；只由种子和候选序号决定
+void LevelGenerator::Build(uint64_t seed, int index, LevelRows& walls) const
+{
+    CounterRng rng(seed, (static_cast<uint64_t>(RngStream::LEVEL) << 32) | static_cast<uint32_t>(index));
+    for (int y = 0; y < config.height; y++)
+    {
+        walls.rows[y] = 0;
+    }
+
+    const int pieces = rng.Range(config.minPieces, config.maxPieces);
+    for (int p = 0; p < pieces; p++)
+    {
+        const int x = rng.Range(0, config.width - 1);
+        const int y = rng.Range(0, config.height - 1);
+        switch (rng.Below(4))
+        {
+        case 0:     //横条
+        {
+            const int len = rng.Range(2, config.maxPieceLength);
+            const uint64_t bar = len >= 64 ? ~uint64_t(0) : (uint64_t(1) << len) - 1;
+            walls.rows[y] |= (bar << x) & rowMask;
+            break;
+        }
+        case 1:     //竖条
+        {
+            const int len = rng.Range(2, config.maxPieceLength);
+            for (int i = 0; i < len && y + i < config.height; i++)
+            {
+                walls.rows[y + i] |= uint64_t(1) << x;
+            }
+            break;
+        }
+        case 2:     //L形：横竖各一段，共用拐角
+        {
+            const int len = rng.Range(2, config.maxPieceLength / 2 + 2);
+            walls.rows[y] |= ((((uint64_t(1) << len) - 1)) << x) & rowMask;
+            for (int i = 0; i < len && y + i < config.height; i++)
+            {
+                walls.rows[y + i] |= uint64_t(1) << x;
+            }
+            break;
+        }
+        default:    //2x2方块
+            for (int i = 0; i < 2 && y + i < config.height; i++)
+            {
+                walls.rows[y + i] |= (uint64_t(3) << x) & rowMask;
+            }
+            break;
+        }
+    }
+}
+
+bool LevelGenerator::Valid(const LevelRows& walls) const
+{
+    //出生通道畅通，顺便统计空地
+    LevelRows free{};
+    int freeCount = 0;
+    for (int y = 0; y < config.height; y++)
+    {
+        if (walls.rows[y] & spawnCells.rows[y])
+            return false;
+        free.rows[y] = ~walls.rows[y] & rowMask;
+        freeCount += static_cast<int>(std::bitset<64>(free.rows[y]).count());
+    }
+    if (freeCount * 100 < config.minFreePercent * config.width * config.height)
+        return false;
+
+    //从蛇头泛洪，能到达所有空地才算连通
+    LevelRows head{};
+    head.rows[config.spawnY] = uint64_t(1) << config.spawnX;
+    LevelRows reach;
+    FloodRows(free, head, config.height, reach);
+    for (int y = 0; y < config.height; y++)
+    {
+        if (reach.rows[y] != free.rows[y])
+            return false;
+    }
+    return true;
+}
+
+bool LevelGenerator::Candidate(uint64_t seed, int index, LevelRows& walls) const
+{
+    Build(seed, index, walls);
+    return Valid(walls);
+}
+
+//把合格的候选写成关卡：墙以外都可生成食物，出生点一个
+static void ToLevel(const LevelGenConfig& config, uint64_t seed, const LevelRows& walls, LevelData& out)
+{
+    out = LevelData(config.width, config.height);
+    char name[LEVEL_NAME_SIZE];
+    std::snprintf(name, sizeof(name), "gen-%016llx", static_cast<unsigned long long>(seed));
+    out.name = name;
+    for (int y = 0; y < config.height; y++)
+    {
+        for (int x = 0; x < config.width; x++)
+        {
+            const bool wall = (walls.rows[y] >> x) & 1;
+            out.SetWall(x, y, wall);
+            out.SetFood(x, y, !wall);
+        }
+    }
+    out.AddSpawn(config.spawnX, config.spawnY, config.spawnDir);
+}
+
+//单线程：按序号依次尝试
+int LevelGenerator::Generate(uint64_t seed, LevelData& out) const
+{
+    LevelRows walls;
+    for (int i = 0; i < config.maxCandidates; i++)
+    {
+        if (Candidate(seed, i, walls))
+        {
+            ToLevel(config, seed, walls, out);
+            return i;
+        }
+    }
+    return -1;
+}
+
+//多线程：每轮LEVELGEN_ROUND个候选分段并行，每段从小到大尝试，找到合格的或序号超过已知最小值就停下
+//序号更小的候选都已在之前的轮次或本轮中判为不合格，所以结果与单线程版相同
+int LevelGenerator::Generate(uint64_t seed, LevelData& out, ParallelFor& workers) const
+{
+    std::atomic<int> best(config.maxCandidates);
+    for (int base = 0; base < config.maxCandidates && best.load() == config.maxCandidates; base += LEVELGEN_ROUND)
+    {
+        const int n = config.maxCandidates - base < LEVELGEN_ROUND ? config.maxCandidates - base : LEVELGEN_ROUND;
+        workers.Run(n, [&](int begin, int end) {
+            LevelRows walls;
+            for (int i = base + begin; i < base + end && i < best.load(std::memory_order_relaxed); i++)
+            {
+                if (Candidate(seed, i, walls))
+                {
+                    int current = best.load();
+                    while (i < current && !best.compare_exchange_weak(current, i))
+                    {
+                    }
+                    break;
+                }
+            }
+        });
+    }
+
+    const int index = best.load();
+    if (index >= config.maxCandidates)
+        return -1;
+    //合格的候选只记下序号，在调用线程上重新生成一次
+    LevelRows walls;
+    Build(seed, index, walls);
+    ToLevel(config, seed, walls, out);
+    return index;
+}
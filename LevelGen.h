@@ -0,0 +1,56 @@
+﻿// LevelGen.h - 按种子程序生成障碍关卡（每日挑战等）
+// 候选布局由种子和候选序号唯一确定，并行生成、校验后取序号最小的合格候选，结果与线程数无关
+// 校验：所有空地连通（逐行位棋盘泛洪）、出生通道畅通、空地比例不低于下限
+#pragma once
+#include "LevelFile.h"
+#include "ParallelFor.h"
+#include <cstdint>
+
+constexpr int LEVELGEN_MAX_SIDE = 64;       //每行放在一个uint64_t中，宽高都不超过64
+constexpr int LEVELGEN_ROUND = 64;          //每轮并行生成的候选数
+
+struct LevelGenConfig
+{
+    int width = GRID_WIDTH;
+    int height = GRID_HEIGHT;
+    int minPieces = 8;                      //障碍块数
+    int maxPieces = 16;
+    int maxPieceLength = 10;                //条形障碍的最大长度
+    int minFreePercent = 80;                //空地占全场的最小百分比
+    int spawnX = START_LENGTH - 1;          //出生点，默认与没有关卡时相同
+    int spawnY = 3;
+    Direction spawnDir = Direction::RIGHT;
+    int spawnLength = START_LENGTH;         //出生点身后需留空的格数（含蛇头）
+    int corridor = 6;                       //蛇头前方需留空的格数
+    int maxCandidates = 4096;               //超过后放弃
+};
+
+//逐行位棋盘：rows[y]的第x位对应(x, y)
+struct LevelRows
+{
+    uint64_t rows[LEVELGEN_MAX_SIDE];
+};
+
+class LevelGenerator
+{
+private:
+    LevelGenConfig config;
+    uint64_t rowMask;       //一行中有效的位
+    LevelRows spawnCells;   //出生通道
+
+    void Build(uint64_t seed, int index, LevelRows& walls) const;
+    bool Valid(const LevelRows& walls) const;
+
+public:
+    explicit LevelGenerator(const LevelGenConfig& config = LevelGenConfig());
+
+    const LevelGenConfig& Config() const;
+    //第index个候选：生成后校验，返回是否合格
+    bool Candidate(uint64_t seed, int index, LevelRows& walls) const;
+    //生成种子对应的关卡，返回采用的候选序号；maxCandidates个候选都不合格时返回-1
+    int Generate(uint64_t seed, LevelData& out) const;
+    int Generate(uint64_t seed, LevelData& out, ParallelFor& workers) const;
+};
+
+//位棋盘泛洪：从seed出发，在free内沿上下左右扩展，返回能到达的格子
+void FloodRows(const LevelRows& free, const LevelRows& seed, int height, LevelRows& reach);
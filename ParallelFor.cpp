@@ -0,0 +1,87 @@
+﻿// ParallelFor.cpp - 分段并行循环实现
+#include "ParallelFor.h"
+
+ParallelFor::ParallelFor(int threads)
+    : job(nullptr), total(0), generation(0), pending(0), stopping(false)
+{
+    for (int i = 1; i < threads; i++)
+    {
+        workers.emplace_back(&ParallelFor::WorkerLoop, this, i);
+    }
+}
+
+ParallelFor::~ParallelFor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers)
+    {
+        t.join();
+    }
+}
+
+int ParallelFor::Threads() const
+{
+    return static_cast<int>(workers.size()) + 1;
+}
+
+//第index段：[n*index/T, n*(index+1)/T)
+void ParallelFor::RunRange(int index, const Job& fn, int n) const
+{
+    const long long threads = Threads();
+    const int begin = static_cast<int>(n * static_cast<long long>(index) / threads);
+    const int end = static_cast<int>(n * static_cast<long long>(index + 1) / threads);
+    if (begin < end)
+        fn(begin, end);
+}
+
+void ParallelFor::WorkerLoop(int index)
+{
+    unsigned seen = 0;
+    for (;;)
+    {
+        const Job* fn;
+        int n;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            fn = job;
+            n = total;
+        }
+        RunRange(index, *fn, n);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0)
+                done.notify_one();
+        }
+    }
+}
+
+void ParallelFor::Run(int n, const Job& fn)
+{
+    if (workers.empty())
+    {
+        if (n > 0)
+            fn(0, n);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        total = n;
+        pending = static_cast<int>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+    RunRange(0, fn, n);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return pending == 0; });
+    job = nullptr;
+}
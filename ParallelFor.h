@@ -0,0 +1,38 @@
+﻿// ParallelFor.h - 固定线程组上的分段并行循环
+// 线程在构造时创建并常驻，每次Run把[0, n)均分给所有线程（调用线程也承担一段），全部完成后返回
+// 每段的范围只取决于n和线程数，各段只写自己范围内的数据时结果与线程数无关
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ParallelFor
+{
+public:
+    using Job = std::function<void(int begin, int end)>;
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;   //有新任务或要退出
+    std::condition_variable done;   //所有工作线程完成本轮
+    const Job* job;                 //本轮任务，只在Run期间有效
+    int total;                      //本轮的循环长度
+    unsigned generation;            //每次Run加一，工作线程据此判断是否有新任务
+    int pending;                    //本轮尚未完成的工作线程数
+    bool stopping;
+
+    void WorkerLoop(int index);
+    void RunRange(int index, const Job& fn, int n) const;
+
+public:
+    explicit ParallelFor(int threads);  //threads包括调用线程，小于1时按1处理
+    ~ParallelFor();
+    ParallelFor(const ParallelFor&) = delete;
+    ParallelFor& operator=(const ParallelFor&) = delete;
+
+    int Threads() const;
+    void Run(int n, const Job& fn);
+};
@@ -0,0 +1,260 @@
+﻿// Renderer.cpp - 蛇与食物的EasyX绘制
+#include "Renderer.h"
+#include <cmath>
+#include <chrono>
+
+void Renderer::DrawSnake(const Snake& snake)
+{
+    // 使用时间戳创建脉动效果
+    auto now = std::chrono::steady_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+
+    // 绘制蛇身
+    const size_t length = snake.getsize();
+    const int* color = snake.GetColor();
+    for (size_t i = 0; i < length; i++)
+    {
+        const SnakeNode seg = snake.GetNode(i);
+
+        // 计算脉动效果
+        // 每个节点有不同的脉动偏移
+        double pulse = sin((ms + static_cast<long long>(i) * 10) * 0.01) * 0.1 + 0.9;
+
+        // 计算颜色渐变：从头部到尾部逐渐变暗
+        double alpha = 1.0 - (i * 0.7 / length);
+        if (alpha < 0.3) alpha = 0.3;
+
+        COLORREF segmentColor = RGB(
+            static_cast<int>(color[0] * alpha * pulse),
+            static_cast<int>(color[1] * alpha * pulse),
+            static_cast<int>(color[2] * alpha * pulse)
+        );
+
+        setfillcolor(segmentColor);
+        setlinecolor(RGB(255, 255, 255));  // 白色边框让蛇更明显
+
+        // 计算大小（头部更大）
+        int size = MYSIZE;
+        if (i == 0) {
+            size = static_cast<int>(MYSIZE * 1.2); // 头部更大
+        }
+        else {
+            size = static_cast<int>(MYSIZE * (1.0 - i * 0.1 / length));
+            if (size < MYSIZE * 0.7) size = static_cast<int>(MYSIZE * 0.7);
+        }
+
+        // 绘制圆角矩形作为蛇身段
+        int offset = (MYSIZE - size) / 2;
+        fillroundrect(
+            seg.x + offset,
+            seg.y + offset,
+            seg.x + MYSIZE - offset,
+            seg.y + MYSIZE - offset,
+            8, 8
+        );
+
+        // 绘制边框
+        setlinecolor(RGB(255, 255, 255));
+        roundrect(
+            seg.x + offset,
+            seg.y + offset,
+            seg.x + MYSIZE - offset,
+            seg.y + MYSIZE - offset,
+            8, 8
+        );
+    }
+
+    // 绘制蛇头特征（眼睛）- 保持不变
+    if (length > 0) {
+        const SnakeNode head = snake.GetNode(0);
+
+        // 根据方向确定眼睛位置
+        int eyeSize = MYSIZE / 5;
+        int eyeOffset = MYSIZE / 3;
+
+        POINT leftEye, rightEye;
+
+        switch (snake.GetDirection()) {
+        case Direction::UP:
+            leftEye = { head.x + eyeOffset, head.y + eyeOffset };
+            rightEye = { head.x + MYSIZE - eyeOffset, head.y + eyeOffset };
+            break;
+        case Direction::DOWN:
+            leftEye = { head.x + eyeOffset, head.y + MYSIZE - eyeOffset };
+            rightEye = { head.x + MYSIZE - eyeOffset, head.y + MYSIZE - eyeOffset };
+            break;
+        case Direction::LEFT:
+            leftEye = { head.x + eyeOffset, head.y + eyeOffset };
+            rightEye = { head.x + eyeOffset, head.y + MYSIZE - eyeOffset };
+            break;
+        case Direction::RIGHT:
+            leftEye = { head.x + MYSIZE - eyeOffset, head.y + eyeOffset };
+            rightEye = { head.x + MYSIZE - eyeOffset, head.y + MYSIZE - eyeOffset };
+            break;
+        }
+
+        // 绘制眼睛
+        setfillcolor(RGB(255, 255, 255));
+        solidcircle(leftEye.x, leftEye.y, eyeSize);
+        solidcircle(rightEye.x, rightEye.y, eyeSize);
+
+        setfillcolor(RGB(0, 0, 0));
+        solidcircle(leftEye.x, leftEye.y, eyeSize / 2);
+        solidcircle(rightEye.x, rightEye.y, eyeSize / 2);
+    }
+}
+
+void Renderer::DrawSnakeUI(const Snake& snake)
+{
+    //打印已经获得的分数
+    settextcolor(WHITE);
+    setbkmode(TRANSPARENT);
+    settextstyle(16, 0, _T("宋体"));
+    outtextxy(WIDTH - 120, 10, _T("分数:"));
+    TCHAR scoreStr[10];
+    _stprintf_s(scoreStr, _T("%d"), snake.GetScore());
+    outtextxy(WIDTH - 50, 10, scoreStr);
+
+    // 显示长度
+    outtextxy(WIDTH - 120, 35, _T("长度:"));
+    TCHAR lengthStr[10];
+    _stprintf_s(lengthStr, _T("%zu"), snake.getsize());
+    outtextxy(WIDTH - 50, 35, lengthStr);
+}
+
+void Renderer::DrawFoods(const FoodPool& foods)
+{
+    for (int i = 0; i < foods.Count(); i++)
+    {
+        const int x = CellX(foods.CellAt(i));
+        const int y = CellY(foods.CellAt(i));
+        switch (foods.KindAt(i))
+        {
+        case FOOD_BIG:
+            DrawBigFood(x, y);
+            break;
+        default:
+            DrawFood(x, y);
+            break;
+        }
+    }
+}
+
+void Renderer::DrawWalls(const LevelView& level)
+{
+    setlinecolor(RGB(70, 80, 100));
+    setfillcolor(RGB(110, 120, 140));
+    for (int gy = 0; gy < level.Height(); gy++)
+    {
+        for (int gx = 0; gx < level.Width(); gx++)
+        {
+            if (level.IsWallAt(gx, gy))
+            {
+                fillrectangle(gx * MYSIZE, gy * MYSIZE, (gx + 1) * MYSIZE - 1, (gy + 1) * MYSIZE - 1);
+            }
+        }
+    }
+}
+
+void Renderer::DrawFood(int x, int y)
+{
+    // 使用时间戳创建闪烁效果
+    auto now = std::chrono::steady_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+
+    // 脉动效果
+    double pulse = sin(ms * 0.01) * 0.2 + 0.8;
+
+    // 基础颜色（苹果红）
+    COLORREF baseColor = RGB(255, 50, 50);
+    COLORREF currentColor = RGB(
+        static_cast<int>(GetRValue(baseColor) * pulse),
+        static_cast<int>(GetGValue(baseColor) * pulse),
+        static_cast<int>(GetBValue(baseColor) * pulse)
+    );
+
+    setfillcolor(currentColor);
+    setlinecolor(RGB(255, 255, 255));
+
+    // 绘制食物主体（圆形）
+    int centerX = x + MYSIZE / 2;
+    int centerY = y + MYSIZE / 2;
+    int radius = static_cast<int>(MYSIZE * 0.4 * pulse);
+
+    solidcircle(centerX, centerY, radius);
+
+    // 绘制高光
+    setfillcolor(RGB(255, 255, 255));
+    solidcircle(centerX - radius / 3, centerY - radius / 3, radius / 4);
+
+    // 绘制茎
+    setlinecolor(RGB(100, 200, 100));
+    setlinestyle(PS_SOLID, 2);
+    line(centerX, centerY - radius, centerX, centerY - radius - 5);
+    setlinestyle(PS_SOLID, 1);
+
+    // 绘制叶子
+    setfillcolor(RGB(100, 200, 100));
+    solidcircle(centerX + 2, centerY - radius - 3, 3);
+}
+
+void Renderer::DrawBigFood(int x, int y)
+{
+    // 使用时间戳创建闪烁效果
+    auto now = std::chrono::steady_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+
+    // 更强烈的脉动效果
+    double pulse = sin(ms * 0.015) * 0.3 + 0.7;
+
+    // 基础颜色（金色）
+    COLORREF baseColor = RGB(255, 215, 0);
+    COLORREF currentColor = RGB(
+        static_cast<int>(GetRValue(baseColor) * pulse),
+        static_cast<int>(GetGValue(baseColor) * pulse),
+        static_cast<int>(GetBValue(baseColor) * pulse)
+    );
+
+    setfillcolor(currentColor);
+    setlinecolor(RGB(255, 255, 255));
+
+    // 绘制大食物主体（星星形状）
+    int centerX = x + MYSIZE / 2;
+    int centerY = y + MYSIZE / 2;
+    int outerRadius = static_cast<int>(MYSIZE * 0.5 * pulse);
+    int innerRadius = static_cast<int>(outerRadius * 0.4);
+
+    // 绘制五角星
+    POINT points[10];
+    for (int i = 0; i < 10; i++) {
+        double angle = i * 3.14159 / 5 - 3.14159 / 2;
+        int radius = (i % 2 == 0) ? outerRadius : innerRadius;
+        points[i].x = centerX + static_cast<int>(radius * cos(angle));
+        points[i].y = centerY + static_cast<int>(radius * sin(angle));
+    }
+
+    solidpolygon(points, 10);
+
+    // 添加发光效果
+    setlinecolor(RGB(255, 255, 0));
+    setlinestyle(PS_SOLID, 2);
+    for (int i = 0; i < 5; i++) {
+        double angle = i * 2 * 3.14159 / 5 - 3.14159 / 2;
+        int endX = centerX + static_cast<int>((outerRadius + 5) * cos(angle));
+        int endY = centerY + static_cast<int>((outerRadius + 5) * sin(angle));
+        line(centerX, centerY, endX, endY);
+    }
+    setlinestyle(PS_SOLID, 1);
+}
+
+void Renderer::DrawScorePopup(int x, int y, int score, double progress)
+{
+    // 从食物的位置向上飘起并逐渐变暗
+    const int level = static_cast<int>(255 * (1.0 - progress));
+    settextcolor(RGB(level, level, level / 4));
+    setbkmode(TRANSPARENT);
+    settextstyle(16, 0, _T("宋体"));
+    TCHAR text[16];
+    _stprintf_s(text, _T("+%d"), score);
+    outtextxy(x, y - static_cast<int>(progress * 30), text);
+}
@@ -0,0 +1,19 @@
+﻿// Renderer.h - 游戏前端绘制（依赖EasyX），只读取核心库中的状态
+#pragma once
+#include "common.h"
+#include "snake.h"
+#include "FoodPool.h"
+#include "LevelFile.h"
+#include <graphics.h>
+
+class Renderer
+{
+public:
+    static void DrawSnake(const Snake& snake);      //绘制蛇
+    static void DrawSnakeUI(const Snake& snake);    //打印分数等UI
+    static void DrawFoods(const FoodPool& foods);   //按种类绘制场上所有食物
+    static void DrawWalls(const LevelView& level);  //绘制关卡的墙
+    static void DrawFood(int x, int y);             //绘制食物（像素坐标）
+    static void DrawBigFood(int x, int y);          //绘制大食物
+    static void DrawScorePopup(int x, int y, int score, double progress);  //飘起的得分，progress从0到1
+};
@@ -0,0 +1,81 @@
+﻿// SnakeBody.h - 环形缓冲区实现的蛇身
+#pragma once
+#include <cstddef>
+
+//蛇身容器：固定容量的环形缓冲区
+//下标0为蛇头，size()-1为蛇尾；头部插入和尾部删除均为O(1)，不会移动已有元素
+//Storage为FixedArray（容量编译期确定）或HeapArray（容量在构造时确定），见Board.h
+template <class Storage>
+class SnakeBody
+{
+public:
+    using T = typename Storage::value_type;
+
+private:
+    Storage buf;            //节点存储
+    size_t head;            //蛇头在buf中的下标
+    size_t tail;            //蛇尾在buf中的下标
+    size_t count;           //当前节点数
+
+    //把逻辑下标(从蛇头开始)转换为buf下标，避免取模
+    size_t Slot(size_t i) const
+    {
+        size_t s = head + i;
+        return s >= buf.size() ? s - buf.size() : s;
+    }
+
+public:
+    explicit SnakeBody(size_t capacity = 0)
+    {
+        buf.Init(capacity);
+        clear();
+    }
+
+    size_t capacity() const { return buf.size(); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == buf.size(); }
+
+    void clear()
+    {
+        head = 0;
+        tail = buf.size() - 1;
+        count = 0;
+    }
+
+    //在蛇头前插入新节点（调用者需保证未满）
+    void push_front(const T& value)
+    {
+        head = (head == 0) ? buf.size() - 1 : head - 1;
+        buf[head] = value;
+        if (count++ == 0)
+            tail = head;
+    }
+
+    //在蛇尾后追加节点，用于初始化蛇身（调用者需保证未满）
+    void push_back(const T& value)
+    {
+        tail = (tail + 1 == buf.size()) ? 0 : tail + 1;
+        buf[tail] = value;
+        if (count++ == 0)
+            head = tail;
+    }
+
+    //删除蛇尾节点
+    void pop_back()
+    {
+        if (count == 0)
+            return;
+        tail = (tail == 0) ? buf.size() - 1 : tail - 1;
+        --count;
+    }
+
+    T& front() { return buf[head]; }
+    const T& front() const { return buf[head]; }
+    T& back() { return buf[tail]; }
+    const T& back() const { return buf[tail]; }
+
+    //按从蛇头到蛇尾的顺序访问
+    T& operator[](size_t i) { return buf[Slot(i)]; }
+    const T& operator[](size_t i) const { return buf[Slot(i)]; }
+};
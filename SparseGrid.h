@@ -0,0 +1,304 @@
+﻿// SparseGrid.h - 超大场地的稀疏分块网格
+// 场地按64x64分块，块在第一次写入时才分配并存入哈希表，块内全部清空后释放，
+// 内存只与被占用的面积成正比，与场地尺寸无关；小棋盘仍使用Board.h中的稠密结构
+#pragma once
+#include "Board.h"
+#include <cstdint>
+#include <unordered_map>
+
+constexpr int CHUNK_SHIFT = 6;
+constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;    //每块边长64格，块内每行正好一个uint64_t
+constexpr int CHUNK_MASK = CHUNK_SIZE - 1;
+constexpr int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+
+constexpr int SPARSE_MAX_LENGTH = 1 << 16;      //稀疏棋盘上蛇身的默认最大节数
+constexpr int SPARSE_PICK_TRIES = 64;           //随机抽取空闲格时的试探次数
+
+//稀疏棋盘：尺寸在运行期指定，可达十万乘十万格
+//格子编号把行、列分别放在高、低32位（而不是y*w+x），求行列和所在块都只需移位
+class SparseBoard
+{
+private:
+    int w;
+    int h;
+    int maxLength;
+
+public:
+    using Cell = uint64_t;
+    static constexpr int CELLS = 0;
+    static constexpr int WORDS = 0;
+    static constexpr bool ON_STACK = false;
+
+    template <class T, size_t N>
+    using Storage = HeapArray<T>;
+
+    SparseBoard(int width = GRID_WIDTH, int height = GRID_HEIGHT, int maxLength = SPARSE_MAX_LENGTH)
+        : w(width), h(height), maxLength(maxLength) {}
+
+    int Width() const { return w; }
+    int Height() const { return h; }
+    int64_t Cells() const { return static_cast<int64_t>(w) * h; }
+    int MaxLength() const { return maxLength; }
+
+    bool Contains(int gx, int gy) const { return gx >= 0 && gx < w && gy >= 0 && gy < h; }
+    static Cell CellAt(int gx, int gy) { return (static_cast<uint64_t>(gy) << 32) | static_cast<uint32_t>(gx); }
+    static int Col(Cell cell) { return static_cast<int>(static_cast<uint32_t>(cell)); }
+    static int Row(Cell cell) { return static_cast<int>(cell >> 32); }
+
+    //格子所在块的键：块行、块列同样分放在高、低32位
+    static uint64_t ChunkOf(Cell cell) { return ((cell >> (32 + CHUNK_SHIFT)) << 32) | (static_cast<uint32_t>(cell) >> CHUNK_SHIFT); }
+    static uint64_t ChunkAt(int cx, int cy) { return (static_cast<uint64_t>(cy) << 32) | static_cast<uint32_t>(cx); }
+    int ChunksX() const { return (w + CHUNK_MASK) >> CHUNK_SHIFT; }
+    int ChunksY() const { return (h + CHUNK_MASK) >> CHUNK_SHIFT; }
+};
+
+//块键的哈希：相邻块的键只差低位，先打散再进哈希表
+struct ChunkHash
+{
+    size_t operator()(uint64_t key) const { return static_cast<size_t>(RngMix(key)); }
+};
+
+//分块位集：只有含置位格子的块才存在
+class SparseBits
+{
+private:
+    struct Chunk
+    {
+        uint64_t rows[CHUNK_SIZE];  //块内第r行的64格
+        int count;                  //块内置位数，归零时释放整块
+    };
+    std::unordered_map<uint64_t, Chunk, ChunkHash> chunks;
+    int64_t setCount;
+
+    static int RowIn(uint64_t cell) { return SparseBoard::Row(cell) & CHUNK_MASK; }
+    static uint64_t BitIn(uint64_t cell) { return uint64_t(1) << (SparseBoard::Col(cell) & CHUNK_MASK); }
+
+public:
+    SparseBits() : setCount(0) {}
+
+    void Clear()
+    {
+        chunks.clear();
+        setCount = 0;
+    }
+
+    int64_t Count() const { return setCount; }
+    size_t ChunkCount() const { return chunks.size(); }
+
+    bool Test(uint64_t cell) const
+    {
+        const auto it = chunks.find(SparseBoard::ChunkOf(cell));
+        return it != chunks.end() && (it->second.rows[RowIn(cell)] & BitIn(cell)) != 0;
+    }
+
+    void Set(uint64_t cell)
+    {
+        Chunk& chunk = chunks[SparseBoard::ChunkOf(cell)];  //新块值初始化为全0
+        uint64_t& row = chunk.rows[RowIn(cell)];
+        if (!(row & BitIn(cell)))
+        {
+            row |= BitIn(cell);
+            chunk.count++;
+            setCount++;
+        }
+    }
+
+    void Reset(uint64_t cell)
+    {
+        const auto it = chunks.find(SparseBoard::ChunkOf(cell));
+        if (it == chunks.end())
+            return;
+        uint64_t& row = it->second.rows[RowIn(cell)];
+        if (row & BitIn(cell))
+        {
+            row &= ~BitIn(cell);
+            setCount--;
+            if (--it->second.count == 0)
+                chunks.erase(it);
+        }
+    }
+
+    //块内置位的格子数，块不存在时为0
+    int CountIn(uint64_t chunkKey) const
+    {
+        const auto it = chunks.find(chunkKey);
+        return it == chunks.end() ? 0 : it->second.count;
+    }
+};
+
+//分块的格子->值映射，用于按格子查找食物等稀疏对象；同样只为有值的块分配内存
+template <class T>
+class SparseCellMap
+{
+private:
+    struct Chunk
+    {
+        T values[CHUNK_CELLS];
+        uint64_t present[CHUNK_SIZE];   //哪些格子有值
+        int count;
+    };
+    std::unordered_map<uint64_t, Chunk, ChunkHash> chunks;
+
+    static int SlotIn(uint64_t cell) { return ((SparseBoard::Row(cell) & CHUNK_MASK) << CHUNK_SHIFT) | (SparseBoard::Col(cell) & CHUNK_MASK); }
+
+public:
+    void Clear() { chunks.clear(); }
+    size_t ChunkCount() const { return chunks.size(); }
+
+    void Put(uint64_t cell, const T& value)
+    {
+        Chunk& chunk = chunks[SparseBoard::ChunkOf(cell)];
+        const int slot = SlotIn(cell);
+        uint64_t& word = chunk.present[slot >> 6];
+        if (!(word & (uint64_t(1) << (slot & 63))))
+        {
+            word |= uint64_t(1) << (slot & 63);
+            chunk.count++;
+        }
+        chunk.values[slot] = value;
+    }
+
+    //格子上没有值时返回nullptr
+    const T* Find(uint64_t cell) const
+    {
+        const auto it = chunks.find(SparseBoard::ChunkOf(cell));
+        if (it == chunks.end())
+            return nullptr;
+        const int slot = SlotIn(cell);
+        if (!(it->second.present[slot >> 6] & (uint64_t(1) << (slot & 63))))
+            return nullptr;
+        return &it->second.values[slot];
+    }
+
+    void Erase(uint64_t cell)
+    {
+        const auto it = chunks.find(SparseBoard::ChunkOf(cell));
+        if (it == chunks.end())
+            return;
+        const int slot = SlotIn(cell);
+        uint64_t& word = it->second.present[slot >> 6];
+        if (word & (uint64_t(1) << (slot & 63)))
+        {
+            word &= ~(uint64_t(1) << (slot & 63));
+            if (--it->second.count == 0)
+                chunks.erase(it);
+        }
+    }
+};
+
+//稀疏棋盘上的占用位图
+template <>
+class BasicOccupancy<SparseBoard>
+{
+private:
+    SparseBits bits;
+
+public:
+    explicit BasicOccupancy(const SparseBoard& = SparseBoard()) {}
+
+    void Clear() { bits.Clear(); }
+    bool Test(uint64_t cell) const { return bits.Test(cell); }
+    void Set(uint64_t cell) { bits.Set(cell); }
+    void Reset(uint64_t cell) { bits.Reset(cell); }
+    size_t ChunkCount() const { return bits.ChunkCount(); }
+};
+
+//稀疏棋盘上的空闲格：记录被占用的格子，空闲数由总格数减出
+//抽样先在整个场地上随机试探（场地几乎是空的，通常一次命中），
+//占用率很高导致试探失败时，再按块累计空闲数精确定位
+template <>
+class BasicFreeCells<SparseBoard>
+{
+private:
+    SparseBoard board;
+    SparseBits taken;
+
+    //第c块（按行或按列）之后的下一个坐标，最后一块截到棋盘边缘
+    static int ChunkEnd(int c, int limit) { return (c + 1) << CHUNK_SHIFT < limit ? (c + 1) << CHUNK_SHIFT : limit; }
+
+    //块内的空闲格数
+    int ChunkFree(int cx, int cy) const
+    {
+        const int w = ChunkEnd(cx, board.Width()) - (cx << CHUNK_SHIFT);
+        const int h = ChunkEnd(cy, board.Height()) - (cy << CHUNK_SHIFT);
+        return w * h - taken.CountIn(SparseBoard::ChunkAt(cx, cy));
+    }
+
+public:
+    explicit BasicFreeCells(const SparseBoard& board = SparseBoard()) : board(board) {}
+
+    void Clear() { taken.Clear(); }
+    int64_t Count() const { return board.Cells() - taken.Count(); }
+    bool IsFree(uint64_t cell) const { return !taken.Test(cell); }
+    void Take(uint64_t cell) { taken.Set(cell); }
+    void Release(uint64_t cell) { taken.Reset(cell); }
+
+    //从空闲格中均匀抽取一个；没有空闲格时返回-1
+    int64_t Pick(CounterRng& rng) const
+    {
+        const int64_t freeCount = Count();
+        if (freeCount <= 0)
+            return -1;
+
+        for (int i = 0; i < SPARSE_PICK_TRIES; i++)
+        {
+            const uint64_t cell = SparseBoard::CellAt(static_cast<int>(rng.Below(board.Width())),
+                static_cast<int>(rng.Below(board.Height())));
+            if (!taken.Test(cell))
+                return static_cast<int64_t>(cell);
+        }
+
+        //空闲数远小于2^64，取模的偏差可以忽略
+        return At(static_cast<int64_t>(rng.Next() % static_cast<uint64_t>(freeCount)));
+    }
+
+    //第k个空闲格：块按行、块内按行排序；按块累计空闲数定位，开销与块数成正比
+    int64_t At(int64_t k) const
+    {
+        for (int cy = 0; cy < board.ChunksY(); cy++)
+        {
+            for (int cx = 0; cx < board.ChunksX(); cx++)
+            {
+                const int chunkFree = ChunkFree(cx, cy);
+                if (k >= chunkFree)
+                {
+                    k -= chunkFree;
+                    continue;
+                }
+                for (int y = cy << CHUNK_SHIFT; y < ChunkEnd(cy, board.Height()); y++)
+                {
+                    for (int x = cx << CHUNK_SHIFT; x < ChunkEnd(cx, board.Width()); x++)
+                    {
+                        const uint64_t cell = SparseBoard::CellAt(x, y);
+                        if (!taken.Test(cell) && k-- == 0)
+                            return static_cast<int64_t>(cell);
+                    }
+                }
+            }
+        }
+        return -1;
+    }
+
+    //空闲格cell在At中的序号，At(Rank(cell)) == cell；cell需当前空闲，开销同At
+    int64_t Rank(uint64_t cell) const
+    {
+        const int tx = SparseBoard::Col(cell);
+        const int ty = SparseBoard::Row(cell);
+        const int tcx = tx >> CHUNK_SHIFT;
+        const int tcy = ty >> CHUNK_SHIFT;
+        int64_t rank = 0;
+        for (int cy = 0; cy <= tcy; cy++)
+        {
+            for (int cx = 0; cx < (cy < tcy ? board.ChunksX() : tcx); cx++)
+                rank += ChunkFree(cx, cy);
+        }
+        for (int y = tcy << CHUNK_SHIFT; y <= ty; y++)
+        {
+            for (int x = tcx << CHUNK_SHIFT; x < (y < ty ? ChunkEnd(tcx, board.Width()) : tx); x++)
+                rank += taken.Test(SparseBoard::CellAt(x, y)) ? 0 : 1;
+        }
+        return rank;
+    }
+
+    size_t ChunkCount() const { return taken.ChunkCount(); }
+};
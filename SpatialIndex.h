@@ -0,0 +1,59 @@
+﻿// SpatialIndex.h - 格子 -> 值的空间索引
+// 竞技场用它记录每格的占用者，食物池用它从格子查到食物；查找和修改都是一次数组访问
+#pragma once
+#include "SparseGrid.h"
+#include <cstdint>
+
+//格子上没有内容
+constexpr int32_t CELL_EMPTY = -1;
+
+//稠密棋盘用数组，值类型T越小越省内存（食物池用int8_t，可随GameState按字节复制）
+template <class B, class T = int32_t>
+class SpatialIndex
+{
+private:
+    typename B::template Storage<T, B::CELLS> owner;
+
+public:
+    explicit SpatialIndex(const B& board = B())
+    {
+        owner.Init(board.Cells());
+        Clear();
+    }
+
+    void Clear()
+    {
+        for (size_t i = 0; i < owner.size(); i++)
+            owner[i] = static_cast<T>(CELL_EMPTY);
+    }
+
+    int32_t Get(typename B::Cell cell) const { return owner[cell]; }
+    void Set(typename B::Cell cell, int32_t value) { owner[cell] = static_cast<T>(value); }
+};
+
+//稀疏棋盘上用分块映射，只为有内容的块分配内存
+template <class T>
+class SpatialIndex<SparseBoard, T>
+{
+private:
+    SparseCellMap<T> owner;
+
+public:
+    explicit SpatialIndex(const SparseBoard& = SparseBoard()) {}
+
+    void Clear() { owner.Clear(); }
+
+    int32_t Get(uint64_t cell) const
+    {
+        const T* value = owner.Find(cell);
+        return value ? *value : CELL_EMPTY;
+    }
+
+    void Set(uint64_t cell, int32_t value)
+    {
+        if (value == CELL_EMPTY)
+            owner.Erase(cell);
+        else
+            owner.Put(cell, static_cast<T>(value));
+    }
+};
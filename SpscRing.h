@@ -0,0 +1,61 @@
+﻿// SpscRing.h - 单生产者单消费者无锁环形队列
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+//容量N必须是2的幂；生产者只调用Push，消费者只调用Pop/Clear，两者可在不同线程；Size/Empty任意线程都可调用
+template <class T, size_t N>
+class SpscRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing容量必须是2的幂");
+
+private:
+    T buf[N];
+    alignas(64) std::atomic<size_t> head;   //消费者读取位置
+    alignas(64) std::atomic<size_t> tail;   //生产者写入位置
+
+public:
+    SpscRing() : head(0), tail(0) {}
+
+    static constexpr size_t capacity() { return N; }
+
+    //队满时返回false，不覆盖旧数据
+    bool Push(const T& value)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == N)
+            return false;
+        buf[t & (N - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    //队空时返回false
+    bool Pop(T& value)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        value = buf[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    //当前积压数量（并发时为近似值）；先读head再读tail，tail只增不减，所以不会读到head越过tail，
+    //只是两次读取之间队列可能又进出了一些，结果限制在[0, N]内
+    size_t Size() const
+    {
+        const size_t h = head.load(std::memory_order_acquire);
+        const size_t t = tail.load(std::memory_order_acquire);
+        return t > h ? std::min(t - h, N) : 0;
+    }
+
+    bool Empty() const { return Size() == 0; }
+
+    //由消费者调用，丢弃所有积压
+    void Clear()
+    {
+        head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+    }
+};
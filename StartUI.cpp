@@ -7,7 +7,7 @@
 #include <random>
 
 StartUI::StartUI(int w, int h) : width(w), height(h), startGame(false),
-snakeDirection(0), animationCounter(0) {
+snakeDirection(0), animationCounter(0), rng(std::random_device{}(), 0) {
     // ʼɫ
     snakeColor = RGB(0, 255, 128);      // ɫ
     foodColor = RGB(255, 100, 100);     // ɫ
@@ -343,8 +343,8 @@ void StartUI::updateAnimation() {
         if (newHead.y > height + 50) newHead.y = -50;
 
         // ı䷽
-        if (rand() % 100 == 0) {
-            snakeDirection = rand() % 4;
+        if (randomBelow(100) == 0) {
+            snakeDirection = randomBelow(4);
         }
 
         // 
@@ -355,19 +355,19 @@ void StartUI::updateAnimation() {
     }
 
     // 
-    if (particles.size() < 100 && rand() % 3 == 0) {
-        particles.push_back({ rand() % width, rand() % height });
+    if (particles.size() < 100 && randomBelow(3) == 0) {
+        particles.push_back({ randomBelow(width), randomBelow(height) });
     }
 
     // Ƴ
-    if (!particles.empty() && rand() % 10 == 0) {
+    if (!particles.empty() && randomBelow(10) == 0) {
         particles.erase(particles.begin());
     }
 
     // ʳλã΢
     for (size_t i = 0; i < foods.size(); i++) {
-        foods[i].x += rand() % 3 - 1;
-        foods[i].y += rand() % 3 - 1;
+        foods[i].x += randomBelow(3) - 1;
+        foods[i].y += randomBelow(3) - 1;
 
         // ߽
         if (foods[i].x < 0) foods[i].x = 0;
@@ -396,7 +396,7 @@ void StartUI::resetAnimation() {
     // 
     particles.clear();
     for (int i = 0; i < 50; i++) {
-        particles.push_back({ rand() % width, rand() % height });
+        particles.push_back({ randomBelow(width), randomBelow(height) });
     }
 }
 
@@ -410,6 +410,11 @@ bool StartUI::isPointInButton(int x, int y) {
         y >= buttonY && y <= buttonY + buttonHeight);
 }
 
+// õÿStartUIʵȫrand()
+int StartUI::randomBelow(int n) {
+    return static_cast<int>(rng.Below(static_cast<uint32_t>(n)));
+}
+
 COLORREF StartUI::getRandomColor() {
-    return RGB(rand() % 256, rand() % 256, rand() % 256);
+    return RGB(randomBelow(256), randomBelow(256), randomBelow(256));
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <string>
 #include <random>
 #include <functional>
+#include "GameRng.h"
 
 class StartUI {
 private:
@@ -21,6 +22,7 @@ private:
     COLORREF snakeColor;
     COLORREF foodColor;
     COLORREF backgroundColor;
+    CounterRng rng;
 
 public:
     StartUI(int w = 800, int h = 600);
@@ -36,6 +38,7 @@ private:
     void resetAnimation();
     bool isPointInButton(int x, int y);
     COLORREF getRandomColor();
+    int randomBelow(int n);
     void drawGradientBackground();
     void drawGridPattern();
 };
\ No newline at end of file
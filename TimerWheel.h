@@ -0,0 +1,197 @@
+﻿// TimerWheel.h - 以逻辑帧为单位的分层时间轮
+// 用于大食物过期、道具、限时效果等定时事件：登记和取消都是O(1)，推进时只处理到期的槽
+// 共4层、每层64槽，可覆盖64^4（约1677万）帧；节点放在定长数组中，用下标串成双向链表，
+// 整个时间轮可以按字节复制，随GameState一起快照/恢复
+#pragma once
+#include <cstdint>
+
+constexpr int WHEEL_BITS = 6;
+constexpr int WHEEL_SLOTS = 1 << WHEEL_BITS;
+constexpr int WHEEL_LEVELS = 4;
+constexpr int TIMER_CAPACITY = 64;      //同时存在的定时器上限
+
+//定时器句柄：低16位是节点下标+1，高16位是节点的代数，节点回收后旧句柄自动失效
+using TimerId = uint32_t;
+constexpr TimerId TIMER_NONE = 0;
+
+//定时事件的种类
+enum TimerKind : uint16_t
+{
+    TIMER_FOOD_EXPIRE = 1,      //限时食物过期，payload为食物所在格子
+};
+
+class TimerWheel
+{
+private:
+    static constexpr int16_t NIL = -1;
+    static constexpr uint16_t UNLINKED = 0xFFFF;
+
+    struct Node
+    {
+        uint64_t payload;   //足以放下稀疏棋盘的格子编号
+        uint32_t expire;    //到期的逻辑帧
+        uint16_t kind;
+        uint16_t generation;
+        uint16_t bucket;    //所在的槽（层*64+槽号），空闲时为UNLINKED
+        int16_t prev;
+        int16_t next;
+    };
+
+    Node nodes[TIMER_CAPACITY];
+    int16_t heads[WHEEL_LEVELS * WHEEL_SLOTS];
+    int16_t freeHead;       //空闲节点链表，复用next
+    uint32_t now;           //已处理到的逻辑帧
+    int active;
+
+    void PushFront(int bucket, int i)
+    {
+        nodes[i].bucket = static_cast<uint16_t>(bucket);
+        nodes[i].prev = NIL;
+        nodes[i].next = heads[bucket];
+        if (heads[bucket] != NIL)
+            nodes[heads[bucket]].prev = static_cast<int16_t>(i);
+        heads[bucket] = static_cast<int16_t>(i);
+    }
+
+    void Unlink(int i)
+    {
+        Node& n = nodes[i];
+        if (n.prev != NIL)
+            nodes[n.prev].next = n.next;
+        else
+            heads[n.bucket] = n.next;
+        if (n.next != NIL)
+            nodes[n.next].prev = n.prev;
+        n.bucket = UNLINKED;
+    }
+
+    //按距到期的帧数放进对应层：第l层容纳64^l <= 距离 < 64^(l+1)的定时器，槽号取到期帧的第l组6位
+    void Link(int i)
+    {
+        const uint32_t expire = nodes[i].expire;
+        const uint32_t delta = expire - now;
+        int level = 0;
+        while (level < WHEEL_LEVELS - 1 && delta >= (uint32_t(1) << (WHEEL_BITS * (level + 1))))
+        {
+            level++;
+        }
+        const int slot = (expire >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1);
+        PushFront(level * WHEEL_SLOTS + slot, i);
+    }
+
+    void Release(int i)
+    {
+        nodes[i].generation++;
+        nodes[i].next = freeHead;
+        freeHead = static_cast<int16_t>(i);
+        active--;
+    }
+
+    static int IndexOf(TimerId id) { return static_cast<int>(id & 0xFFFF) - 1; }
+
+    //把一个槽中的定时器取出，按当前时间重新放到更低的层
+    void Cascade(int bucket)
+    {
+        int i = heads[bucket];
+        heads[bucket] = NIL;
+        while (i != NIL)
+        {
+            const int next = nodes[i].next;
+            Link(i);
+            i = next;
+        }
+    }
+
+public:
+    TimerWheel() { Clear(0); }
+
+    //取消所有定时器，并把当前时间设为start
+    void Clear(uint32_t start)
+    {
+        for (int b = 0; b < WHEEL_LEVELS * WHEEL_SLOTS; b++)
+        {
+            heads[b] = NIL;
+        }
+        for (int i = 0; i < TIMER_CAPACITY; i++)
+        {
+            nodes[i].generation = 0;
+            nodes[i].bucket = UNLINKED;
+            nodes[i].next = static_cast<int16_t>(i + 1 < TIMER_CAPACITY ? i + 1 : NIL);
+        }
+        freeHead = 0;
+        now = start;
+        active = 0;
+    }
+
+    //在第expire帧触发（不早于下一帧）；定时器已满时返回TIMER_NONE
+    TimerId Schedule(uint32_t expire, uint16_t kind, uint64_t payload = 0)
+    {
+        if (freeHead == NIL)
+            return TIMER_NONE;
+        const int i = freeHead;
+        freeHead = nodes[i].next;
+        active++;
+
+        Node& n = nodes[i];
+        n.expire = static_cast<int32_t>(expire - now) > 0 ? expire : now + 1;
+        n.kind = kind;
+        n.payload = payload;
+        Link(i);
+        return (static_cast<uint32_t>(n.generation) << 16) | static_cast<uint32_t>(i + 1);
+    }
+
+    //取消尚未触发的定时器；句柄已失效（已触发、已取消）时返回false
+    bool Cancel(TimerId id)
+    {
+        if (!Pending(id))
+            return false;
+        const int i = IndexOf(id);
+        Unlink(i);
+        Release(i);
+        return true;
+    }
+
+    bool Pending(TimerId id) const
+    {
+        const int i = IndexOf(id);
+        return i >= 0 && i < TIMER_CAPACITY && nodes[i].bucket != UNLINKED
+            && nodes[i].generation == static_cast<uint16_t>(id >> 16);
+    }
+
+    //推进到第tick帧，依次触发期间到期的定时器：fire(kind, payload)
+    //回调中可以登记新的定时器
+    template <class F>
+    void Advance(uint32_t tick, F&& fire)
+    {
+        while (now != tick)
+        {
+            if (active == 0)
+            {
+                now = tick;
+                return;
+            }
+            now++;
+            //到达高层的槽边界时先把该槽降级，从高层到低层依次进行
+            for (int level = WHEEL_LEVELS - 1; level > 0; level--)
+            {
+                if ((now & ((uint32_t(1) << (WHEEL_BITS * level)) - 1)) == 0)
+                    Cascade(level * WHEEL_SLOTS + ((now >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1)));
+            }
+            //第0层当前槽中的定时器正好在本帧到期
+            //逐个摘下再触发，回调里取消同一槽中的其他定时器也是安全的
+            const int bucket = now & (WHEEL_SLOTS - 1);
+            while (heads[bucket] != NIL)
+            {
+                const int i = heads[bucket];
+                const uint16_t kind = nodes[i].kind;
+                const uint64_t payload = nodes[i].payload;
+                Unlink(i);
+                Release(i);
+                fire(kind, payload);
+            }
+        }
+    }
+
+    uint32_t Now() const { return now; }
+    int Active() const { return active; }
+};
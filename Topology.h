@@ -0,0 +1,154 @@
+﻿// Topology.h - 棋盘拓扑：矩形边界、环面、迷宫墙和传送门
+// 每个(格子, 方向)的下一格预先算好存在表里，移动只需一次查表，不再按方向分支和判断边界；
+// 撞墙（出界或进入墙格）用TOPOLOGY_WALL表示
+// 拓扑建好后只读，同一棋盘上的多局游戏共用一份
+#pragma once
+#include "SparseGrid.h"
+#include <cstdint>
+#include <vector>
+
+constexpr int32_t TOPOLOGY_WALL = -1;      //下一格是墙
+
+//四个方向的坐标增量，下标为Direction的枚举值（UP, DOWN, RIGHT, LEFT）
+constexpr int TOPOLOGY_DX[4] = { 0, 0, 1, -1 };
+constexpr int TOPOLOGY_DY[4] = { -1, 1, 0, 0 };
+
+//没有查找表时按坐标走一步：矩形边界，出界为TOPOLOGY_WALL
+//很大的运行时棋盘上查找表放不进缓存，BasicSnake和竞技场没有设置拓扑时都用它
+template <class B>
+int64_t StepRect(const B& board, typename B::Cell cell, Direction dir)
+{
+    const int nx = board.Col(cell) + TOPOLOGY_DX[static_cast<int>(dir)];
+    const int ny = board.Row(cell) + TOPOLOGY_DY[static_cast<int>(dir)];
+    if (!board.Contains(nx, ny))
+        return TOPOLOGY_WALL;
+    return static_cast<int64_t>(board.CellAt(nx, ny));
+}
+
+//B为棋盘类型；表按格子编号*4+方向存放，标准棋盘约26KB
+template <class B>
+class BasicTopology
+{
+public:
+    using Cell = typename B::Cell;
+
+private:
+    B board;
+    bool wrap;                                                  //出界时从对边进入
+    typename B::template Storage<int32_t, B::CELLS * 4> next;   //每个(格子, 方向)的下一格
+    typename B::template Storage<int32_t, B::CELLS> partner;    //传送门另一端，不是传送门时为-1
+    BasicOccupancy<B> walls;
+    std::vector<Cell> wallList;                                 //所有墙格，供生成食物时排除
+
+public:
+    explicit BasicTopology(const B& board = B(), bool wrap = false) : board(board), wrap(wrap), walls(board)
+    {
+        next.Init(static_cast<size_t>(board.Cells()) * 4);
+        partner.Init(board.Cells());
+        for (size_t i = 0; i < partner.size(); i++)
+            partner[i] = -1;
+        Build();
+    }
+
+    //AddWall/AddPortal只登记，全部登记完后调用Build重建查找表
+    void AddWall(int gx, int gy)
+    {
+        const Cell cell = static_cast<Cell>(board.CellAt(gx, gy));
+        if (!walls.Test(cell))
+        {
+            walls.Set(cell);
+            wallList.push_back(cell);
+        }
+    }
+
+    //进入a格的蛇从b格出来，反之亦然
+    void AddPortal(int ax, int ay, int bx, int by)
+    {
+        const int a = board.CellAt(ax, ay);
+        const int b = board.CellAt(bx, by);
+        partner[a] = b;
+        partner[b] = a;
+    }
+
+    void Build()
+    {
+        const int w = board.Width();
+        const int h = board.Height();
+        for (int gy = 0; gy < h; gy++)
+        {
+            for (int gx = 0; gx < w; gx++)
+            {
+                const size_t base = static_cast<size_t>(board.CellAt(gx, gy)) * 4;
+                for (int d = 0; d < 4; d++)
+                {
+                    int nx = gx + TOPOLOGY_DX[d];
+                    int ny = gy + TOPOLOGY_DY[d];
+                    if (wrap)
+                    {
+                        nx = nx < 0 ? w - 1 : (nx == w ? 0 : nx);
+                        ny = ny < 0 ? h - 1 : (ny == h ? 0 : ny);
+                    }
+                    int32_t target = TOPOLOGY_WALL;
+                    if (board.Contains(nx, ny))
+                    {
+                        target = board.CellAt(nx, ny);
+                        if (walls.Test(target))
+                            target = TOPOLOGY_WALL;
+                        else if (partner[target] >= 0)
+                            target = partner[target];
+                    }
+                    next[base + d] = target;
+                }
+            }
+        }
+    }
+
+    //沿dir走一步到达的格子，撞墙时为TOPOLOGY_WALL
+    int32_t Next(Cell cell, Direction dir) const
+    {
+        return next[static_cast<size_t>(cell) * 4 + static_cast<size_t>(dir)];
+    }
+
+    bool IsWall(Cell cell) const { return walls.Test(cell); }
+    bool Wraps() const { return wrap; }
+    const std::vector<Cell>& Walls() const { return wallList; }
+    const BasicOccupancy<B>& WallMask() const { return walls; }    //墙格位图
+    const B& GetBoard() const { return board; }
+};
+
+//稀疏棋盘可达十万乘十万格，放不下查找表，按坐标计算；只支持矩形边界和环面
+template <>
+class BasicTopology<SparseBoard>
+{
+public:
+    using Cell = SparseBoard::Cell;
+
+private:
+    SparseBoard board;
+    bool wrap;
+    std::vector<Cell> wallList;     //始终为空
+
+public:
+    explicit BasicTopology(const SparseBoard& board = SparseBoard(), bool wrap = false) : board(board), wrap(wrap) {}
+
+    int64_t Next(Cell cell, Direction dir) const
+    {
+        int nx = SparseBoard::Col(cell) + TOPOLOGY_DX[static_cast<int>(dir)];
+        int ny = SparseBoard::Row(cell) + TOPOLOGY_DY[static_cast<int>(dir)];
+        if (wrap)
+        {
+            nx = nx < 0 ? board.Width() - 1 : (nx == board.Width() ? 0 : nx);
+            ny = ny < 0 ? board.Height() - 1 : (ny == board.Height() ? 0 : ny);
+        }
+        if (!board.Contains(nx, ny))
+            return TOPOLOGY_WALL;
+        return static_cast<int64_t>(SparseBoard::CellAt(nx, ny));
+    }
+
+    bool IsWall(Cell) const { return false; }
+    bool Wraps() const { return wrap; }
+    const std::vector<Cell>& Walls() const { return wallList; }
+    const SparseBoard& GetBoard() const { return board; }
+};
+
+using Topology = BasicTopology<StandardBoard>;
@@ -0,0 +1,113 @@
+﻿// TranspositionTable.h - 以局面哈希为键的置换表，供搜索型AI和回放去重使用
+// 容量在构造时固定（桶数取2的幂），多线程无锁读写：每项存两个64位字data和check = key ^ data，
+// 分别原子写入；读到被并发写入撕裂的项时校验不通过，按未命中处理，不需要加锁
+// 每个桶两项：第一项按深度替换（新结果的深度不低于已有结果时才覆盖），第二项总是覆盖，
+// 深层的结果不会被大量浅层结果挤掉，最新的结果也总有位置
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+constexpr int TT_VALUE_BYTES = 6;   //值最多6字节，与深度一起放进一个64位字
+constexpr int TT_MAX_DEPTH = 255;
+
+template <class T>
+class TranspositionTable
+{
+    static_assert(std::is_trivially_copyable<T>::value && sizeof(T) <= TT_VALUE_BYTES, "置换表的值须可按字节复制且不超过6字节");
+
+private:
+    static constexpr uint64_t VALUE_MASK = (uint64_t(1) << 48) - 1;
+    static constexpr int DEPTH_SHIFT = 48;
+    static constexpr uint64_t VALID = uint64_t(1) << 56;   //区分空项与键为0的项
+
+    struct Entry
+    {
+        std::atomic<uint64_t> check;    //key ^ data
+        std::atomic<uint64_t> data;     //0~47位为值，48~55位为深度，56位为有效标志
+    };
+
+    struct alignas(32) Bucket
+    {
+        Entry deep;     //按深度替换
+        Entry recent;   //总是替换
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    uint64_t mask;
+
+    static uint64_t Pack(const T& value, int depth)
+    {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(T));
+        const uint64_t d = depth < 0 ? 0 : depth > TT_MAX_DEPTH ? TT_MAX_DEPTH : static_cast<uint64_t>(depth);
+        return (bits & VALUE_MASK) | (d << DEPTH_SHIFT) | VALID;
+    }
+
+    static int DepthOf(uint64_t data) { return static_cast<int>((data >> DEPTH_SHIFT) & 0xFF); }
+
+    //项中存的是key的结果时取出数据
+    static bool Read(const Entry& entry, uint64_t key, uint64_t& data)
+    {
+        data = entry.data.load(std::memory_order_relaxed);
+        return (data & VALID) && (entry.check.load(std::memory_order_relaxed) ^ data) == key;
+    }
+
+    static void Write(Entry& entry, uint64_t key, uint64_t data)
+    {
+        entry.data.store(data, std::memory_order_relaxed);
+        entry.check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+public:
+    //entries为期望的项数，实际容量是不小于它的2的幂（至少一个桶）
+    explicit TranspositionTable(size_t entries)
+    {
+        size_t count = 1;
+        while (count * 2 < entries)
+            count <<= 1;
+        buckets.reset(new Bucket[count]);
+        mask = count - 1;
+        Clear();
+    }
+
+    size_t Capacity() const { return static_cast<size_t>(mask + 1) * 2; }
+
+    //清空所有项，不能与其他线程的读写同时进行
+    void Clear()
+    {
+        for (uint64_t i = 0; i <= mask; i++)
+        {
+            Write(buckets[i].deep, 0, 0);
+            Write(buckets[i].recent, 0, 0);
+        }
+    }
+
+    //查找key，命中时取出值和当时的深度；两项都是key时取深的一项
+    bool Probe(uint64_t key, T& value, int& depth) const
+    {
+        const Bucket& bucket = buckets[key & mask];
+        uint64_t data;
+        if (!Read(bucket.deep, key, data) && !Read(bucket.recent, key, data))
+            return false;
+        const uint64_t bits = data & VALUE_MASK;
+        std::memcpy(&value, &bits, sizeof(T));
+        depth = DepthOf(data);
+        return true;
+    }
+
+    //写入key的结果：深度不低于深度项（或深度项为空）时覆盖深度项，否则写入替换项
+    void Store(uint64_t key, const T& value, int depth)
+    {
+        Bucket& bucket = buckets[key & mask];
+        const uint64_t data = Pack(value, depth);
+        const uint64_t deep = bucket.deep.data.load(std::memory_order_relaxed);
+        if (!(deep & VALID) || DepthOf(data) >= DepthOf(deep))
+            Write(bucket.deep, key, data);
+        else
+            Write(bucket.recent, key, data);
+    }
+};
@@ -0,0 +1,117 @@
+﻿// WorkStealing.cpp - 工作窃取调度器实现
+#include "WorkStealing.h"
+#include "GameRng.h"
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    //一个线程的待办区间[lo, hi)，lo在高32位；独占缓存行，避免相邻线程互相干扰
+    struct alignas(64) TaskRange
+    {
+        std::atomic<uint64_t> packed;
+    };
+
+    uint64_t Pack(uint32_t lo, uint32_t hi) { return (static_cast<uint64_t>(lo) << 32) | hi; }
+    uint32_t Lo(uint64_t r) { return static_cast<uint32_t>(r >> 32); }
+    uint32_t Hi(uint64_t r) { return static_cast<uint32_t>(r); }
+
+    //从自己区间的低端取一个任务
+    bool TakeOwn(TaskRange& own, int& task)
+    {
+        uint64_t r = own.packed.load(std::memory_order_acquire);
+        while (Lo(r) < Hi(r))
+        {
+            if (own.packed.compare_exchange_weak(r, Pack(Lo(r) + 1, Hi(r)), std::memory_order_acq_rel))
+            {
+                task = static_cast<int>(Lo(r));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //从victim区间的高端偷走剩余任务的一半（至少一个），放进自己已空的区间
+    bool StealHalf(TaskRange& victim, TaskRange& own)
+    {
+        uint64_t r = victim.packed.load(std::memory_order_acquire);
+        while (Lo(r) < Hi(r))
+        {
+            const uint32_t take = (Hi(r) - Lo(r) + 1) / 2;
+            if (victim.packed.compare_exchange_weak(r, Pack(Lo(r), Hi(r) - take), std::memory_order_acq_rel))
+            {
+                own.packed.store(Pack(Hi(r) - take, Hi(r)), std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+WorkStealingScheduler::WorkStealingScheduler(int threads)
+    : threads(threads > 0 ? threads : 1), steals(0)
+{
+}
+
+int WorkStealingScheduler::Threads() const
+{
+    return threads;
+}
+
+long long WorkStealingScheduler::Steals() const
+{
+    return steals.load();
+}
+
+void WorkStealingScheduler::Run(int tasks, const Task& fn)
+{
+    std::unique_ptr<TaskRange[]> ranges(new TaskRange[threads]);
+    for (int w = 0; w < threads; w++)
+    {
+        const uint32_t lo = static_cast<uint32_t>(static_cast<long long>(tasks) * w / threads);
+        const uint32_t hi = static_cast<uint32_t>(static_cast<long long>(tasks) * (w + 1) / threads);
+        ranges[w].packed.store(Pack(lo, hi));
+    }
+
+    auto worker = [&](int w)
+    {
+        //每个线程用自己的随机数挑选偷取对象，避免所有线程同时盯住同一个
+        CounterRng rng(static_cast<uint64_t>(w), static_cast<uint64_t>(RngStream::EFFECT));
+        for (;;)
+        {
+            int task;
+            while (TakeOwn(ranges[w], task))
+            {
+                fn(w, task);
+            }
+
+            bool stole = false;
+            const int start = static_cast<int>(rng.Below(static_cast<uint32_t>(threads)));
+            for (int k = 0; k < threads && !stole; k++)
+            {
+                const int victim = (start + k) % threads;
+                if (victim != w && StealHalf(ranges[victim], ranges[w]))
+                {
+                    stole = true;
+                    steals.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            //所有区间都已取空：剩下的任务正由取到它们的线程执行，本线程可以退出
+            if (!stole)
+                return;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < threads; w++)
+    {
+        pool.emplace_back(worker, w);
+    }
+    worker(0);
+    for (std::thread& t : pool)
+    {
+        t.join();
+    }
+}
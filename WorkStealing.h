@@ -0,0 +1,23 @@
+﻿// WorkStealing.h - 工作窃取调度器
+// 任务编号[0, tasks)先均分给各工作线程；每个线程从自己区间的低端逐个取任务，
+// 取完后从其他线程区间的高端偷走剩余的一半。区间打包在一个64位原子量里，取和偷都是一次CAS，不加锁
+#pragma once
+#include <atomic>
+#include <functional>
+
+class WorkStealingScheduler
+{
+public:
+    using Task = std::function<void(int worker, int task)>;
+
+private:
+    int threads;
+    std::atomic<long long> steals;  //成功偷取的次数
+
+public:
+    explicit WorkStealingScheduler(int threads);   //小于1时按1处理
+
+    int Threads() const;
+    long long Steals() const;
+    void Run(int tasks, const Task& fn);            //所有任务完成后返回，worker为执行线程的编号
+};
@@ -0,0 +1,41 @@
+﻿// Zobrist.h - 局面的64位Zobrist哈希
+// 局面的哈希是其中每一项（蛇身格、蛇头格、朝向、待增长、各种食物所在格）对应键的异或，
+// 蛇和食物池在格子变化时把对应的键异或进出，Move、Eat和生成食物都只需O(1)更新
+// 键由(种类, 格子)经RngMix现算，不建表：任意尺寸的棋盘（包括稀疏棋盘）都适用，且同一局面在任何进程中哈希相同
+#pragma once
+#include "GameDefs.h"
+#include "GameRng.h"
+#include <cstdint>
+
+//键的种类，占格子编号左移后的低4位
+enum ZobristPiece : uint64_t
+{
+    ZOBRIST_BODY = 0,       //蛇身占据的格子（包括蛇头）
+    ZOBRIST_HEAD = 1,       //蛇头所在的格子
+    ZOBRIST_DIRECTION = 2,  //朝向，"格子"为Direction的值
+    ZOBRIST_GROW = 3,       //下一次移动会增长
+    ZOBRIST_FOOD = 4,       //食物，加上FoodKind，最多12种
+    ZOBRIST_PIECES = 16
+};
+
+constexpr uint64_t ZOBRIST_SEED = 0x5EED2B0B7157ACEDull;
+
+inline uint64_t ZobristKey(uint64_t piece, uint64_t cell)
+{
+    return RngMix(ZOBRIST_SEED + ((cell << 4) | piece) * 0x9E3779B97F4A7C15ull);
+}
+
+inline uint64_t ZobristDirection(Direction dir)
+{
+    return ZobristKey(ZOBRIST_DIRECTION, static_cast<uint64_t>(dir));
+}
+
+inline uint64_t ZobristGrow()
+{
+    return ZobristKey(ZOBRIST_GROW, 0);
+}
+
+inline uint64_t ZobristFood(uint8_t kind, uint64_t cell)
+{
+    return ZobristKey(ZOBRIST_FOOD + kind, cell);
+}
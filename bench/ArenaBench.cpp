@@ -0,0 +1,57 @@
+﻿// ArenaBench.cpp - 多蛇竞技场的逻辑帧吞吐量
+// 在仓库根目录编译：g++ -O2 -std=c++17 -pthread -I. bench/ArenaBench.cpp Arena.cpp ParallelFor.cpp
+#include "Arena.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+//每条蛇平均占有约400格场地，蛇随机转向，死亡后重生
+//校验值在不同线程数下必须相同
+template <class B>
+void RunArena(const char* name, int snakes, const B& board, int ticks, int threads)
+{
+    using Clock = std::chrono::steady_clock;
+
+    BasicArena<B> arena(board, snakes, snakes, 42);
+    ParallelFor workers(threads);
+    CounterRng bot(42, 99);
+    long long moved = 0;
+    long long deaths = 0;
+    const auto start = Clock::now();
+    for (int t = 0; t < ticks; t++)
+    {
+        for (int id = 0; id < snakes; id++)
+        {
+            if (bot.Below(8) == 0)
+                arena.SetDirection(id, static_cast<Direction>(bot.Below(4)));
+        }
+        const ArenaStats stats = threads > 1 ? arena.Step(workers) : arena.Step();
+        moved += stats.moved;
+        deaths += stats.deaths;
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << name << " " << snakes << "条蛇 (" << board.Width() << "x" << board.Height() << ", "
+        << threads << "线程): " << ticks / seconds << " 逻辑帧/秒, " << moved / seconds / 1e6
+        << " M蛇步/秒, 平均每帧死亡" << static_cast<double>(deaths) / ticks
+        << ", 校验值" << std::hex << arena.Checksum() << std::dec << std::endl;
+}
+
+int main()
+{
+    const int counts[] = { 100, 1000, 10000 };
+    const int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (int snakes : counts)
+    {
+        const int side = static_cast<int>(std::sqrt(snakes * 400.0));
+        const int ticks = 2000000 / snakes;
+        RunArena("DynamicBoard", snakes, DynamicBoard(side, side), ticks, 1);
+        RunArena("SparseBoard ", snakes, SparseBoard(side, side), ticks, 1);
+        for (int threads = 2; threads <= maxThreads; threads *= 2)
+        {
+            RunArena("DynamicBoard", snakes, DynamicBoard(side, side), ticks, threads);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+﻿// BatchBench.cpp - 批量模拟器吞吐量：N = 1k ~ 1M局同步推进，随机转向和贪心两种策略
+// 随机转向的局几十帧就撞墙，局/秒主要反映重开的开销；贪心策略的局能活上千帧，逻辑帧/秒才是推进本身的速度
+// 在仓库根目录编译：g++ -O2 -std=c++17 -pthread -I. bench/BatchBench.cpp BatchSim.cpp BatchKernels.cpp ParallelFor.cpp
+#include "BatchSim.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+    ParallelFor workers(threads);
+
+    const struct
+    {
+        BatchPolicy policy;
+        const char* name;
+    } policies[] = { { BatchPolicy::RANDOM, "随机转向" }, { BatchPolicy::BOT, "贪心" } };
+    const int sizes[] = { 1000, 10000, 100000, 1000000 };
+    for (const auto& p : policies)
+    {
+        for (int games : sizes)
+        {
+            BatchSim batch(games, 2024);
+            batch.UsePolicy(p.policy);
+            const int steps = std::max(20, 20000000 / games);
+            const auto start = Clock::now();
+            for (int t = 0; t < steps; t++)
+            {
+                batch.Step(workers, 12);
+            }
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            const BatchStats stats = batch.Stats();
+            std::cout << p.name << " N=" << games << " (" << threads << "线程): " << stats.ticks / seconds / 1e6 << " M逻辑帧/秒, "
+                << stats.finished / seconds << " 局/秒, 平均得分"
+                << (stats.finished ? static_cast<double>(stats.totalScore) / stats.finished : 0.0) << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+﻿// BitboardBench.cpp - 位棋盘运算与逐格循环的对比（标准52x32棋盘）
+// 在仓库根目录编译：g++ -O2 -std=c++17 -I. bench/BitboardBench.cpp GameCore.cpp snake.cpp LevelFile.cpp
+// 加-mavx2编译时邻格扩展使用AVX2
+#include "GameCore.h"
+#include "Bitboard.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int REPEAT = 200000;
+
+template <class F>
+static double NsPer(F&& f)
+{
+    const auto start = Clock::now();
+    for (int i = 0; i < REPEAT; i++)
+        f(i);
+    return std::chrono::duration<double>(Clock::now() - start).count() * 1e9 / REPEAT;
+}
+
+int main()
+{
+    //开局长度40的蛇随机走一段，作为各项运算的输入
+    GameRules rules;
+    rules.initialLength = 40;
+    GameCore core(5, StandardBoard(), rules);
+    InputQueue input;
+    CounterRng bot(5, 1);
+    uint64_t seed = 5;
+    for (int t = 0; t < 60 || core.IsGameOver(); t++)
+    {
+        if (core.IsGameOver())
+        {
+            core.Reset(++seed);
+            t = 0;
+        }
+        if (bot.Below(6) == 0)
+            input.Push({ t, static_cast<Direction>(bot.Below(4)) });
+        core.Step(input);
+    }
+    const Snake& snake = core.GetSnake();
+    const StandardBoard board;
+    long long sink = 0;
+
+    //空闲格计数：逐格查空闲格索引 vs 占用位图取反后计数
+    const double loopCount = NsPer([&](int) {
+        int n = 0;
+        for (int c = 0; c < GRID_CELLS; c++)
+            n += snake.GetFreeCells().IsFree(c);
+        sink += n;
+    });
+    const double bitCount = NsPer([&](int) {
+        sink += (~Bitboard::FromWords(snake.GetOccupancy().Words())).Count();
+    });
+    std::cout << "空闲格计数: 逐格 " << loopCount << " ns, 位棋盘 " << bitCount << " ns" << std::endl;
+
+    //食物生成的兜底抽取：逐格收集候选 vs 位棋盘求可用格再按序号选取
+    const double loopPick = NsPer([&](int i) {
+        std::vector<int> candidates;
+        for (int gy = 0; gy < board.Height(); gy++)
+        {
+            for (int gx = 0; gx < board.Width(); gx++)
+            {
+                const int cell = board.CellAt(gx, gy);
+                if (snake.GetFreeCells().IsFree(cell) && core.GetFoods().CanPlace(cell))
+                    candidates.push_back(cell);
+            }
+        }
+        sink += candidates[i % candidates.size()];
+    });
+    const double bitPick = NsPer([&](int i) {
+        Bitboard open = ~Bitboard::FromWords(snake.GetOccupancy().Words());
+        for (int f = 0; f < core.GetFoods().Count(); f++)
+            open.Reset(core.GetFoods().CellAt(f));
+        sink += open.Select(i % open.Count());
+    });
+    std::cout << "可用格抽取: 逐格 " << loopPick << " ns, 位棋盘 " << bitPick << " ns" << std::endl;
+
+    //邻格扩展一步和从蛇头出发的可达区域
+    const Bitboard passable = ~Bitboard::FromWords(snake.GetOccupancy().Words());
+    Bitboard head;
+    head.Set(snake.GetHeadCell());
+    const double expand = NsPer([&](int) {
+        Bitboard out;
+        sink += Bitboard::Expand(passable, passable, out);
+    });
+    const double neighbors = NsPer([&](int) {
+        sink += head.Neighbors().Count();
+    });
+    const Bitboard start = head.Neighbors() & passable;
+    const double reach = NsPer([&](int) {
+        sink += Bitboard::Reachable(start, passable).Count();
+    });
+    std::cout << "邻格扩展一步 " << expand << " ns, 四邻 " << neighbors << " ns, 可达区域("
+        << Bitboard::Reachable(start, passable).Count() << "格) " << reach << " ns" << std::endl;
+    std::cout << "(" << (sink & 1) << ")" << std::endl;
+    return 0;
+}
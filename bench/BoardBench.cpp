@@ -0,0 +1,70 @@
+﻿// BoardBench.cpp - 不同棋盘类型的逻辑帧吞吐量对比，重开一局（Reset）的开销单独列出
+// 在仓库根目录编译：g++ -O2 -std=c++17 -I. bench/BoardBench.cpp GameCore.cpp snake.cpp
+#include "GameCore.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+//一种棋盘的测量结果
+struct BoardResult
+{
+    double ticksPerSecond;  //只算Step的时间
+    int resets;
+    double resetMicros;     //每次Reset的平均微秒数
+};
+
+//随机转向跑满TICKS帧，死亡后用新种子重开
+//随机转向的蛇几十帧就会撞墙，大棋盘上Reset要清空整张网格，开销远大于几十帧，所以单独计时，逻辑帧/秒不含重开
+template <class B>
+BoardResult RunBoard(const B& board)
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr int TICKS = 2000000;
+
+    auto core = std::make_unique<BasicGameCore<B>>(1, board);
+    InputQueue input;
+    CounterRng bot(7, 99);
+    uint64_t seed = 1;
+    BoardResult result{};
+    Clock::duration resetTime{};
+    const auto start = Clock::now();
+    for (int i = 0; i < TICKS; i++)
+    {
+        if (core->IsGameOver())
+        {
+            const auto resetStart = Clock::now();
+            core->Reset(++seed);
+            resetTime += Clock::now() - resetStart;
+            result.resets++;
+        }
+        //约每8帧尝试一次转向，避免频繁撞墙
+        if (bot.Below(8) == 0)
+        {
+            input.Push({ i, static_cast<Direction>(bot.Below(4)) });
+        }
+        core->Step(input);
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start - resetTime).count();
+    result.ticksPerSecond = TICKS / seconds;
+    result.resetMicros = result.resets > 0 ? std::chrono::duration<double, std::micro>(resetTime).count() / result.resets : 0.0;
+    return result;
+}
+
+template <class B>
+void Report(const char* name, const B& board = B())
+{
+    const BoardResult result = RunBoard(board);
+    std::cout << name << " (" << board.Width() << "x" << board.Height() << ", 状态"
+        << sizeof(BasicGameState<B>) << "字节): " << result.ticksPerSecond / 1e6 << " M逻辑帧/秒, 重开"
+        << result.resets << "次, 每次" << result.resetMicros << "微秒" << std::endl;
+}
+
+int main()
+{
+    Report<TinyBoard>("TinyBoard");
+    Report<StandardBoard>("StandardBoard");
+    Report<LargeBoard>("LargeBoard");
+    Report<DynamicBoard>("DynamicBoard", DynamicBoard(GRID_WIDTH, GRID_HEIGHT));
+    Report<SparseBoard>("SparseBoard", SparseBoard(100000, 100000));
+    return 0;
+}
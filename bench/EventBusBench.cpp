@@ -0,0 +1,131 @@
+﻿// EventBusBench.cpp - 事件总线的开销：逻辑帧在不投递、投递给空闲订阅者和投递给慢订阅者时的耗时，以及各订阅者的积压指标
+// 存档订阅者登记为无损，跟不上时事件进入溢出表而不是丢弃，对局结束后再等它写完
+// 在仓库根目录编译：g++ -O2 -std=c++17 -pthread -I. bench/EventBusBench.cpp GameCore.cpp snake.cpp LevelFile.cpp
+#include "GameCore.h"
+#include "EventBus.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int TICKS = 4000000;
+
+//在自己的线程里取事件的订阅者；delay不为0时每条事件模拟一次耗时的写入
+struct ConsumerSpec
+{
+    const char* name;
+    int delayUs;
+    bool lossless;
+};
+
+struct Consumer
+{
+    int id;
+    std::chrono::microseconds delay;
+    long long handled = 0;
+    std::thread thread;
+};
+
+//随机对局推进ticks帧，返回每帧纳秒数
+static double RunTicks(EventBus* bus, int ticks = TICKS)
+{
+    GameCore core(1);
+    core.SetEventBus(bus);
+    InputQueue input;
+    CounterRng bot(7, 99);
+    uint64_t seed = 1;
+    const auto start = Clock::now();
+    for (int i = 0; i < ticks; i++)
+    {
+        if (core.IsGameOver())
+            core.Reset(++seed);
+        if (bot.Below(8) == 0)
+            input.Push({ i, static_cast<Direction>(bot.Below(4)) });
+        core.Step(input);
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count() * 1e9 / ticks;
+}
+
+static void PrintMetrics(const EventBus& bus)
+{
+    for (int i = 0; i < bus.SubscriberCount(); i++)
+    {
+        const EventBus::Metrics m = bus.GetMetrics(i);
+        std::cout << "  " << m.name << ": 已投递 " << m.delivered << ", 溢出 " << m.spilled << ", 丢弃 " << m.dropped
+            << ", 积压 " << m.backlog << ", 峰值积压 " << m.peak << std::endl;
+    }
+}
+
+//订阅者在各自线程中取事件，对局结束后把溢出表补完、等订阅者取完再停止，打印指标
+static void WithConsumers(const char* title, const std::vector<ConsumerSpec>& subscribers, int ticks = TICKS)
+{
+    EventBus bus;
+    std::vector<Consumer> consumers(subscribers.size());
+    std::atomic<bool> stop(false);
+    for (size_t i = 0; i < subscribers.size(); i++)
+    {
+        consumers[i].id = bus.Subscribe(subscribers[i].name, EVENT_MASK_ALL, subscribers[i].lossless);
+        consumers[i].delay = std::chrono::microseconds(subscribers[i].delayUs);
+    }
+    for (Consumer& c : consumers)
+    {
+        c.thread = std::thread([&bus, &stop, &c]()
+        {
+            GameEvent event;
+            while (true)
+            {
+                const bool stopping = stop.load(std::memory_order_acquire);
+                bool any = false;
+                while (bus.Poll(c.id, event))
+                {
+                    any = true;
+                    c.handled++;
+                    if (c.delay.count() > 0)
+                        std::this_thread::sleep_for(c.delay);
+                }
+                if (stopping)
+                    break;
+                if (!any)
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    const double ns = RunTicks(&bus, ticks);
+    const auto drainStart = Clock::now();
+    while (bus.Pump())
+        std::this_thread::yield();
+    stop.store(true, std::memory_order_release);
+    for (Consumer& c : consumers)
+        c.thread.join();
+    const double drainMs = std::chrono::duration<double>(Clock::now() - drainStart).count() * 1e3;
+    std::cout << title << ": " << ns << " ns/帧，对局结束后等待订阅者取完 " << drainMs << " ms" << std::endl;
+    PrintMetrics(bus);
+    for (size_t i = 0; i < consumers.size(); i++)
+    {
+        const EventBus::Metrics m = bus.GetMetrics(consumers[i].id);
+        if (static_cast<uint64_t>(consumers[i].handled) != m.delivered)
+            std::cout << "  [" << m.name << "取到的事件数与投递数不一致]" << std::endl;
+    }
+}
+
+int main()
+{
+    std::cout << "不投递事件: " << RunTicks(nullptr) << " ns/帧" << std::endl;
+
+    //只登记、不取走：队列很快填满，之后的事件全部丢弃，衡量投递本身和满队列时的开销
+    {
+        EventBus bus;
+        bus.Subscribe("idle");
+        std::cout << "一个不取事件的订阅者: " << RunTicks(&bus) << " ns/帧" << std::endl;
+        PrintMetrics(bus);
+    }
+
+    WithConsumers("存档、绘制、统计三个订阅者", { { "db", 0, true }, { "render", 0, false }, { "stats", 0, false } });
+    //每条事件耗时100微秒的存档订阅者跟不上：它的事件进入溢出表、一条不丢，逻辑帧和其他订阅者不受影响
+    WithConsumers("存档订阅者每条耗时100us", { { "db", 100, true }, { "render", 0, false } }, TICKS / 40);
+    return 0;
+}
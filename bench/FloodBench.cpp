@@ -0,0 +1,184 @@
+﻿// FloodBench.cpp - 位棋盘可达区域内核（FloodFill.h）与逐格队列BFS的对比
+// 标准52x32棋盘（对局中的蛇，带和不带蛇身让出时间）和512x512竞技场（空场、随机墙、逐步打开的隔墙）
+// 在仓库根目录编译：g++ -O2 -std=c++17 -I. bench/FloodBench.cpp GameCore.cpp snake.cpp LevelFile.cpp
+// 加-mavx2编译时邻格扩展使用AVX2
+// 512x512空场和逐步打开的隔墙上，菱形波前覆盖的每一行每步都在变化，能跳过的字很少，只比队列BFS快1.3到2倍左右
+#include "GameCore.h"
+#include "FloodFill.h"
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+static double UsPer(int repeat, F&& f)
+{
+    const auto start = Clock::now();
+    for (int i = 0; i < repeat; i++)
+        f();
+    return std::chrono::duration<double>(Clock::now() - start).count() * 1e6 / repeat;
+}
+
+//逐格的对照实现：按步推进的队列BFS，暂时被占的格子等到让出时间再进入，等待规则与FloodFill相同
+template <class B>
+class QueueFlood
+{
+private:
+    using Pending = std::pair<int, int>;    //(让出时间, 格子)
+    std::vector<int> when;                  //0为空闲，INT_MAX为永久占用，其余为让出时间
+    std::vector<int> seen;                  //到达时的轮次编号，免去每次清零
+    std::vector<int> frontier;
+    std::vector<int> next;
+    int round;
+
+public:
+    explicit QueueFlood(const BasicBitboard<B>& passable, const std::vector<Pending>& releases)
+        : when(B::CELLS), seen(B::CELLS, 0), round(0)
+    {
+        for (int c = 0; c < B::CELLS; c++)
+            when[c] = passable.Test(c) ? 0 : INT_MAX;
+        for (const Pending& r : releases)
+            when[r.second] = r.first;
+    }
+
+    FloodResult Run(int startCell, int target)
+    {
+        round++;
+        std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> pending;
+        frontier.assign(1, startCell);
+        seen[startCell] = round;
+        FloodResult result = { 0, 0, target == startCell ? 0 : FLOOD_NO_TARGET };
+        for (int step = 1;; step++)
+        {
+            next.clear();
+            for (const int u : frontier)
+            {
+                const int x = B::Col(u);
+                const int y = B::Row(u);
+                const int around[4] = { y > 0 ? u - B::Width() : -1, y < B::Height() - 1 ? u + B::Width() : -1,
+                    x > 0 ? u - 1 : -1, x < B::Width() - 1 ? u + 1 : -1 };
+                for (const int v : around)
+                {
+                    if (v < 0 || seen[v] == round || when[v] == INT_MAX)
+                        continue;
+                    if (when[v] <= step)
+                    {
+                        seen[v] = round;
+                        next.push_back(v);
+                    }
+                    else
+                    {
+                        pending.push({ when[v], v });
+                    }
+                }
+            }
+            while (!pending.empty() && pending.top().first <= step)
+            {
+                const int v = pending.top().second;
+                pending.pop();
+                if (seen[v] != round)
+                {
+                    seen[v] = round;
+                    next.push_back(v);
+                }
+            }
+            if (next.empty())
+            {
+                if (pending.empty() || pending.top().first - 1 > result.cells)
+                    break;
+                step = pending.top().first - 1;
+                continue;
+            }
+            result.cells += static_cast<int>(next.size());
+            result.steps = step;
+            if (result.targetStep < 0 && target != FLOOD_NO_TARGET && seen[target] == round)
+                result.targetStep = step;
+            frontier.swap(next);
+        }
+        return result;
+    }
+};
+
+template <class B>
+static void Compare(const char* name, const BasicBitboard<B>& passable, int startCell,
+    const std::vector<std::pair<int, int>>& releases, int target, int repeat)
+{
+    BasicFloodFill<B> flood;
+    for (const auto& r : releases)
+        flood.AddRelease(r.second, r.first);
+    BasicBitboard<B> start;
+    start.Set(startCell);
+    QueueFlood<B> queue(passable, releases);
+
+    FloodResult bits{};
+    FloodResult ref{};
+    const double bitUs = UsPer(repeat, [&]() { bits = flood.Run(start, passable, target); });
+    const double queueUs = UsPer(repeat, [&]() { ref = queue.Run(startCell, target); });
+    const bool same = bits.cells == ref.cells && bits.steps == ref.steps && bits.targetStep == ref.targetStep;
+    std::cout << name << ": " << bits.cells << "格 " << bits.steps << "步 目标" << bits.targetStep
+        << "，队列BFS " << queueUs << " us，位棋盘 " << bitUs << " us，加速 " << queueUs / bitUs
+        << (same ? "" : "  [结果不一致]") << std::endl;
+}
+
+int main()
+{
+    //标准棋盘：开局长度40的蛇随机走一段，从蛇头出发，目标为蛇尾
+    GameRules rules;
+    rules.initialLength = 40;
+    GameCore core(5, StandardBoard(), rules);
+    InputQueue input;
+    CounterRng bot(5, 1);
+    uint64_t seed = 5;
+    for (int t = 0; t < 60 || core.IsGameOver(); t++)
+    {
+        if (core.IsGameOver())
+        {
+            core.Reset(++seed);
+            t = 0;
+        }
+        if (bot.Below(6) == 0)
+            input.Push({ t, static_cast<Direction>(bot.Below(4)) });
+        core.Step(input);
+    }
+    const Snake& snake = core.GetSnake();
+    const int length = static_cast<int>(snake.getsize());
+    const int head = snake.GetHeadCell();
+    const int tail = snake.GetCell(static_cast<size_t>(length - 1));
+    const Bitboard open = ~Bitboard::FromWords(snake.GetOccupancy().Words());
+    std::vector<std::pair<int, int>> body;
+    for (int i = length - 1; i > 0; i--)
+        body.push_back({ length - i, snake.GetCell(static_cast<size_t>(i)) });
+
+    Compare<StandardBoard>("52x32 空场", Bitboard::Full(), StandardBoard::CellAt(26, 16), {}, FLOOD_NO_TARGET, 20000);
+    Compare<StandardBoard>("52x32 蛇身不动", open, head, {}, tail, 20000);
+    Compare<StandardBoard>("52x32 蛇身逐节让出", open, head, body, tail, 20000);
+
+    //512x512竞技场：从中心出发
+    using Large = BasicBitboard<LargeBoard>;
+    const int center = LargeBoard::CellAt(256, 256);
+    Compare<LargeBoard>("512x512 空场", Large::Full(), center, {}, FLOOD_NO_TARGET, 20);
+
+    Large walls = Large::Full();
+    CounterRng rng(7, 2);
+    for (int c = 0; c < LargeBoard::CELLS; c++)
+    {
+        if (c != center && rng.Below(100) < 30)
+            walls.Reset(c);
+    }
+    Compare<LargeBoard>("512x512 30%随机墙", walls, center, {}, FLOOD_NO_TARGET, 20);
+
+    //第300行是一堵从左往右逐格让出的隔墙（像一条长蛇的身体），上方出发，目标在隔墙下方
+    Large split = Large::Full();
+    std::vector<std::pair<int, int>> gate;
+    for (int x = 0; x < LargeBoard::Width(); x++)
+    {
+        split.Reset(LargeBoard::CellAt(x, 300));
+        gate.push_back({ 200 + x * 4, LargeBoard::CellAt(x, 300) });
+    }
+    Compare<LargeBoard>("512x512 逐步打开的隔墙", split, LargeBoard::CellAt(256, 100), gate, LargeBoard::CellAt(256, 400), 20);
+    return 0;
+}
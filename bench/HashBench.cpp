@@ -0,0 +1,117 @@
+﻿// HashBench.cpp - Zobrist哈希的正确性与开销，以及置换表的多线程吞吐量
+// 在仓库根目录编译：g++ -O2 -std=c++17 -pthread -I. bench/HashBench.cpp GameCore.cpp snake.cpp LevelFile.cpp
+#include "GameCore.h"
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int TICKS = 4000000;
+constexpr int TT_OPS = 8000000;     //每个线程的读写次数
+
+//随机对局：每帧对比增量哈希与从头计算的结果，并统计走到过的不同局面
+static void CheckHash()
+{
+    GameCore core(1);
+    InputQueue input;
+    CounterRng bot(7, 99);
+    uint64_t seed = 1;
+    long long mismatched = 0;
+    std::unordered_set<uint64_t> seen;
+    for (int i = 0; i < TICKS / 10; i++)
+    {
+        if (core.IsGameOver())
+            core.Reset(++seed);
+        if (bot.Below(8) == 0)
+            input.Push({ i, static_cast<Direction>(bot.Below(4)) });
+        core.Step(input);
+        if (core.Hash() != core.ComputeHash())
+            mismatched++;
+        seen.insert(core.Hash());
+    }
+    std::cout << "增量哈希与重算不一致: " << mismatched << "帧, 不同局面" << seen.size() << "/" << TICKS / 10 << std::endl;
+}
+
+//带增量哈希的每帧开销，与TopologyBench中的表格拓扑对比
+static void TickCost()
+{
+    GameCore core(1);
+    InputQueue input;
+    CounterRng bot(7, 99);
+    uint64_t seed = 1;
+    uint64_t sink = 0;
+    const auto start = Clock::now();
+    for (int i = 0; i < TICKS; i++)
+    {
+        if (core.IsGameOver())
+            core.Reset(++seed);
+        if (bot.Below(8) == 0)
+            input.Push({ i, static_cast<Direction>(bot.Below(4)) });
+        core.Step(input);
+        sink ^= core.Hash();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "逻辑帧(含哈希): " << seconds * 1e9 / TICKS << " ns/帧 (" << (sink & 1) << ")" << std::endl;
+}
+
+//每个线程在同一张表上交替写入和查找；值取键的低32位，命中时值与键不符说明读到了撕裂的项
+static void TableThroughput(int threads)
+{
+    TranspositionTable<uint32_t> table(1 << 20);
+    std::vector<long long> hits(threads, 0);
+    std::vector<long long> corrupt(threads, 0);
+    std::vector<std::thread> workers;
+    const auto start = Clock::now();
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]() {
+            CounterRng rng(t, 1);
+            for (int i = 0; i < TT_OPS; i++)
+            {
+                //键取自一个比表大的集合，有命中也有替换
+                const uint64_t key = RngMix(rng.Below(1 << 21));
+                uint32_t value;
+                int depth;
+                if (table.Probe(key, value, depth))
+                {
+                    hits[t]++;
+                    if (value != static_cast<uint32_t>(key))
+                        corrupt[t]++;
+                }
+                else
+                {
+                    table.Store(key, static_cast<uint32_t>(key), static_cast<int>(rng.Below(16)));
+                }
+            }
+        });
+    }
+    for (std::thread& w : workers)
+        w.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    long long totalHits = 0;
+    long long totalCorrupt = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        totalHits += hits[t];
+        totalCorrupt += corrupt[t];
+    }
+    std::cout << "置换表 " << threads << "线程: " << static_cast<double>(TT_OPS) * threads / seconds / 1e6 << " M次/秒, 命中率"
+        << 100.0 * totalHits / (static_cast<double>(TT_OPS) * threads) << "%, 错误命中" << totalCorrupt << std::endl;
+}
+
+int main()
+{
+    CheckHash();
+    TickCost();
+    const int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        TableThroughput(threads);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+﻿// KernelBench.cpp - 批量判定内核的微基准：标量Snake::Eat与SSE4.2/AVX2内核对比
+// 在仓库根目录编译：g++ -O2 -std=c++17 -I. bench/KernelBench.cpp BatchKernels.cpp snake.cpp
+#include "BatchKernels.h"
+#include "snake.h"
+#include "FoodPool.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int GAMES = 4096;
+constexpr int ROUNDS = 20000;
+
+template <class F>
+double NsPerGame(F&& body)
+{
+    const auto start = Clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        body(r);
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ROUNDS / GAMES;
+}
+
+int main()
+{
+    CounterRng rng(1, 1);
+    std::vector<uint16_t> heads(GAMES), foods(GAMES), cells(GAMES);
+    std::vector<int16_t> xs(GAMES), ys(GAMES);
+    std::vector<uint64_t> bits(static_cast<size_t>(GAMES) * StandardBoard::WORDS);
+    std::vector<uint8_t> out(GAMES);
+    for (int i = 0; i < GAMES; i++)
+    {
+        heads[i] = static_cast<uint16_t>(rng.Below(GRID_CELLS));
+        foods[i] = rng.Below(4) == 0 ? heads[i] : static_cast<uint16_t>(rng.Below(GRID_CELLS));
+        cells[i] = static_cast<uint16_t>(rng.Below(GRID_CELLS));
+        xs[i] = static_cast<int16_t>(rng.Range(-1, GRID_WIDTH));
+        ys[i] = static_cast<int16_t>(rng.Range(-1, GRID_HEIGHT));
+    }
+    for (uint64_t& w : bits)
+    {
+        w = rng.Next();
+    }
+
+    //基线：每局一个Snake对象和一个食物池，逐局调用Eat查食物网格
+    std::vector<Snake> snakes(256);
+    std::vector<FoodPool> food(256);
+    for (size_t i = 0; i < snakes.size(); i++)
+    {
+        snakes[i].Reset(rng);
+        food[i].Add(rng.Below(4) == 0 ? snakes[i].GetHeadCell() : static_cast<CellIndex>(rng.Below(GRID_CELLS)),
+            FOOD_NORMAL, FOOD_TYPES[FOOD_NORMAL].score);
+    }
+    long long eaten = 0;
+    const double eatNs = NsPerGame([&](int)
+    {
+        for (int i = 0; i < GAMES; i++)
+        {
+            eaten += snakes[i & 255].Eat(food[i & 255]) >= 0;
+        }
+    });
+    std::cout << "Snake::Eat(标量): " << eatNs << " ns/局 (" << eaten % 2 << ")" << std::endl;
+
+    const SimdLevel levels[] = { SimdLevel::SCALAR, SimdLevel::SSE42, SimdLevel::AVX2 };
+    for (SimdLevel level : levels)
+    {
+        const BatchKernels& k = GetBatchKernels(level);
+        if (k.level != level)
+        {
+            std::cout << "本机不支持该级别，跳过" << std::endl;
+            continue;
+        }
+        long long sink = 0;
+        const double eq = NsPerGame([&](int) { k.equal(heads.data(), foods.data(), GAMES, out.data()); sink += out[0]; });
+        const double inb = NsPerGame([&](int) { k.inBounds(xs.data(), ys.data(), GAMES, GRID_WIDTH, GRID_HEIGHT, out.data()); sink += out[1]; });
+        const double occ = NsPerGame([&](int) { k.occupied(bits.data(), StandardBoard::WORDS, cells.data(), GAMES, out.data()); sink += out[2]; });
+        std::cout << k.name << ": 吃食物 " << eq << " ns/局 (比Eat快" << eatNs / eq << "倍), 出界 "
+            << inb << " ns/局, 撞身 " << occ << " ns/局 (" << sink % 2 << ")" << std::endl;
+    }
+    std::cout << "自动选择: " << ActiveBatchKernels().name << std::endl;
+    return 0;
+}
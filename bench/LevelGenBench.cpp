@@ -0,0 +1,55 @@
+﻿// LevelGenBench.cpp - 程序生成52x32关卡的耗时，单线程与线程组对比
+// 在仓库根目录编译：g++ -O2 -std=c++17 -pthread -I. bench/LevelGenBench.cpp LevelGen.cpp LevelFile.cpp ParallelFor.cpp
+#include "LevelGen.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+constexpr int SEEDS = 20000;
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+    ParallelFor workers(threads);
+    const LevelGenerator generator;
+
+    //单线程：逐个种子生成，同时统计平均尝试的候选数
+    LevelData level;
+    long long candidates = 0;
+    int failed = 0;
+    auto start = Clock::now();
+    for (int s = 0; s < SEEDS; s++)
+    {
+        const int index = generator.Generate(s, level);
+        if (index < 0)
+            failed++;
+        else
+            candidates += index + 1;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "单线程: " << seconds * 1e6 / SEEDS << " us/关卡, 平均尝试" << static_cast<double>(candidates) / SEEDS
+        << "个候选, 失败" << failed << std::endl;
+
+    //线程组：结果须与单线程一致
+    int mismatched = 0;
+    start = Clock::now();
+    for (int s = 0; s < SEEDS; s++)
+    {
+        LevelData parallel;
+        if (generator.Generate(s, parallel, workers) != generator.Generate(s, level) || parallel.walls != level.walls)
+            mismatched++;
+    }
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << threads << "线程(含一次单线程对照): " << seconds * 1e6 / SEEDS << " us/关卡, 结果不一致" << mismatched << std::endl;
+
+    start = Clock::now();
+    for (int s = 0; s < SEEDS; s++)
+    {
+        generator.Generate(s, level, workers);
+    }
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << threads << "线程: " << seconds * 1e6 / SEEDS << " us/关卡" << std::endl;
+    return 0;
+}
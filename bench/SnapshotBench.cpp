@@ -0,0 +1,58 @@
+﻿// SnapshotBench.cpp - GameState快照/恢复吞吐量基准
+// 在仓库根目录编译：g++ -O2 -std=c++17 -I. bench/SnapshotBench.cpp GameCore.cpp snake.cpp
+#include "GameCore.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    //先向右走一段，让对局处于进行中的状态
+    auto core = std::make_unique<GameCore>(12345);
+    InputQueue input;
+    CounterRng bot(12345, 99);
+    for (int i = 0; i < 30; i++)
+    {
+        core->Step(input);
+    }
+
+    std::cout << "sizeof(GameState) = " << sizeof(GameState) << " 字节" << std::endl;
+
+    //快照+恢复的吞吐量
+    constexpr int ROUNDS = 1000000;
+    auto saved = std::make_unique<GameState>();
+    const auto start = Clock::now();
+    for (int i = 0; i < ROUNDS; i++)
+    {
+        core->Snapshot(*saved);
+        core->Restore(*saved);
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "快照+恢复: " << ROUNDS / seconds / 1e6 << " M次/秒, "
+        << seconds * 1e9 / ROUNDS << " ns/次" << std::endl;
+
+    //典型搜索用法：保存一次，向前模拟若干帧后回滚
+    constexpr int ROLLOUTS = 200000;
+    constexpr int DEPTH = 8;
+    long long ticks = 0;
+    core->Snapshot(*saved);
+    const auto rollStart = Clock::now();
+    for (int i = 0; i < ROLLOUTS; i++)
+    {
+        for (int d = 0; d < DEPTH && !core->IsGameOver(); d++)
+        {
+            input.Push({ d, static_cast<Direction>(bot.Below(4)) });
+            core->Step(input);
+            ticks++;
+        }
+        input.Clear();
+        core->Restore(*saved);
+    }
+    const double rollSeconds = std::chrono::duration<double>(Clock::now() - rollStart).count();
+    std::cout << "回滚搜索(深度" << DEPTH << "): " << ROLLOUTS / rollSeconds / 1e6 << " M次回滚/秒, "
+        << ticks / rollSeconds / 1e6 << " M逻辑帧/秒" << std::endl;
+    return 0;
+}
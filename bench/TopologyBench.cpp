@@ -0,0 +1,79 @@
+﻿// TopologyBench.cpp - 各种拓扑下每个逻辑帧的开销
+// 在仓库根目录编译：g++ -O2 -std=c++17 -I. bench/TopologyBench.cpp GameCore.cpp snake.cpp
+#include "GameCore.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+constexpr int TICKS = 4000000;
+
+//随机转向跑满TICKS帧，死亡后用新种子重开；返回每帧纳秒数
+static double NsPerTick(std::shared_ptr<const Topology> topology, long long& deaths)
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto core = std::make_unique<GameCore>(1);
+    core->SetTopology(std::move(topology));
+    core->Reset(1);
+    InputQueue input;
+    CounterRng bot(7, 99);
+    uint64_t seed = 1;
+    deaths = 0;
+    const auto start = Clock::now();
+    for (int i = 0; i < TICKS; i++)
+    {
+        if (core->IsGameOver())
+        {
+            core->Reset(++seed);
+            deaths++;
+        }
+        //约每8帧尝试一次转向
+        if (bot.Below(8) == 0)
+        {
+            input.Push({ i, static_cast<Direction>(bot.Below(4)) });
+        }
+        core->Step(input);
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return seconds * 1e9 / TICKS;
+}
+
+static void Report(const char* name, std::shared_ptr<const Topology> topology)
+{
+    long long deaths = 0;
+    const double ns = NsPerTick(std::move(topology), deaths);
+    std::cout << name << ": " << ns << " ns/帧 (" << deaths << "局)" << std::endl;
+}
+
+int main()
+{
+    CounterRng rng(42, 1);
+
+    //迷宫：约8%的格子是墙，出生的第3行保持畅通
+    auto maze = std::make_shared<Topology>();
+    for (int gy = 0; gy < GRID_HEIGHT; gy++)
+    {
+        for (int gx = 0; gx < GRID_WIDTH; gx++)
+        {
+            if (gy != 3 && rng.Below(100) < 8)
+                maze->AddWall(gx, gy);
+        }
+    }
+    maze->Build();
+
+    //传送门：8对，同样避开第3行
+    auto portal = std::make_shared<Topology>();
+    for (int i = 0; i < 8; i++)
+    {
+        portal->AddPortal(rng.Below(GRID_WIDTH), 4 + rng.Below(GRID_HEIGHT - 4),
+            rng.Below(GRID_WIDTH), 4 + rng.Below(GRID_HEIGHT - 4));
+    }
+    portal->Build();
+
+    Report("矩形(按坐标计算)", nullptr);
+    Report("矩形(查表)", std::make_shared<Topology>());
+    Report("环面", std::make_shared<Topology>(StandardBoard(), true));
+    Report("迷宫", maze);
+    Report("传送门", portal);
+    return 0;
+}
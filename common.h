@@ -1,27 +1,13 @@
 #pragma once
 
 #include<Windows.h>
-//峡С
-constexpr auto WIDTH = 1040;
-constexpr auto HEIGHT = 640;
+//ƽ̨޹صĳߴ硢ȳGameDefs.hֻŽصĶ
+#include "GameDefs.h"
 
-//ʳԼߵĵλС
-constexpr auto MYSIZE = 20;
-
-enum class Direction //öٶߵĳ
-{
-    UP,
-    DOWN,
-    RIGHT,
-    LEFT
-};
-
-constexpr auto MAXSIZE = 1600; //൱ߵ󳤶
-constexpr auto SPEED = 150;    //ٶ
-constexpr auto BIGFOOD_DURATION = 5000; //BigFoodʾmsʱ
 // common.hɫ
 constexpr auto SNAKE_HEAD_COLOR = RGB(0, 255, 128);
 constexpr auto SNAKE_BODY_COLOR = RGB(0, 200, 100);
 constexpr auto FOOD_COLOR = RGB(255, 50, 50);
 constexpr auto BIG_FOOD_COLOR = RGB(255, 215, 0);
-constexpr auto BACKGROUND_COLOR = RGB(10, 20, 30);
\ No newline at end of file
+constexpr auto BACKGROUND_COLOR = RGB(10, 20, 30);
+constexpr int POPUP_MICROS = 600000;     //ԵʳʱƮʱ΢룩
\ No newline at end of file
@@ -1,16 +1,76 @@
 ﻿#include "Game.h"
 
-Game::Game() : gameover(false), should_break(false), bigFoodActive(false),
-startUI(800, 600)  // 初始化开始界面
+Game::Game() : keyHeld{ false, false, false, false }, timestep(SPEED), dbEvents(-1), renderEvents(-1),
+dbStop(false), dbHandled(0), startUI(800, 600),  // 初始化开始界面
+should_break(false), currentPlayerId(0), currentRecordId(0)
 {
     Initialize();
 }
 Game::~Game()
 {
+    stopEvents();     // 先写完积压的事件
     saveGameResult(); // 确保游戏退出时保存进度
     closegraph();
 }
 
+// 数据库订阅者：在单独的线程中把吃食物和死亡写入数据库
+void Game::dbWorker()
+{
+    GameEvent event;
+    while (true) {
+        // 先读停止标志再取事件，停止前投递的事件都会写完
+        const bool stopping = dbStop.load(std::memory_order_acquire);
+        bool any = false;
+        while (events.Poll(dbEvents, event)) {
+            any = true;
+            // 主线程只在flushEvents之后、下一局开始之前更换记录ID，这里读到的总是事件所属那一局的
+            const int recordId = currentRecordId.load(std::memory_order_acquire);
+            switch (event.type) {
+            case GameEventType::FOOD_EATEN:
+                // 记录食物被吃，种类名称取自食物属性表
+                database.addFoodRecord(recordId, FOOD_TYPES[event.kind].name, event.value, event.x, event.y);
+                break;
+            case GameEventType::DIED:
+            case GameEventType::BOARD_FULL:
+                if (recordId > 0) {
+                    database.endGame(recordId, event.score, event.length, event.count, 0,
+                        event.type == GameEventType::DIED ? "FAILED" : "COMPLETED");
+                }
+                break;
+            default:
+                break;
+            }
+            dbHandled.fetch_add(1, std::memory_order_release);
+        }
+        if (stopping) {
+            break;
+        }
+        if (!any) {
+            Sleep(1);
+        }
+    }
+}
+
+// 等数据库线程写完已发出的事件，包括暂存在溢出表中的；主线程读写数据库或更换记录ID之前调用
+void Game::flushEvents()
+{
+    if (!dbThread.joinable()) {
+        return;
+    }
+    while (events.Pump() || dbHandled.load(std::memory_order_acquire) < events.GetMetrics(dbEvents).delivered) {
+        Sleep(1);
+    }
+}
+
+void Game::stopEvents()
+{
+    if (dbThread.joinable()) {
+        flushEvents();
+        dbStop.store(true, std::memory_order_release);
+        dbThread.join();
+    }
+}
+
 std::string Game::generatePlayerName() {
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -18,13 +78,30 @@ std::string Game::generatePlayerName() {
     return "Player_" + std::to_string(dis(gen));
 }
 
+// 每局游戏的随机种子，记录下来即可配合输入重现整局
+uint64_t Game::newGameSeed()
+{
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+}
+
+// 开始新的一局：先换好记录ID再开局，新一局的事件都写到新记录下；种子保存在记录的game_seed列中
+void Game::startNewGame()
+{
+    const uint64_t seed = newGameSeed();
+    currentRecordId.store(database.startGame(currentPlayerId, seed), std::memory_order_release);
+    core->Reset(seed);
+    input.Clear();
+}
+
 void Game::saveGameResult()
 {
-    if (currentRecordId > 0 && !gameover) {
+    if (core != nullptr && currentRecordId > 0 && !core->IsGameOver()) {
+        const Snake& snake = core->GetSnake();
         database.endGame(currentRecordId,
-            snake->GetScore(),
-            static_cast<int>(snake->getsize()),
-            snake->GetCount(),
+            snake.GetScore(),
+            static_cast<int>(snake.getsize()),
+            snake.GetCount(),
             0,
             "PAUSED");
     }
@@ -116,6 +193,56 @@ void Game::showPlayerStats() {
     _getch();
 }
 
+// 从system_config重新读取规则，只在两局之间调用（逻辑帧中不访问数据库）
+// 新规则整体替换旧规则：帧周期立即更新，核心中的规则在下一次Reset时生效
+void Game::reloadRules()
+{
+    GameRules loaded;
+    database.loadGameRules(loaded);
+    if (core != nullptr && loaded == rules) {
+        return;
+    }
+
+    rules = loaded;
+    timestep.SetPeriod(rules.tickPeriod);
+    if (core != nullptr) {
+        core->SetRules(rules);
+    }
+    std::cout << "规则: 逻辑帧周期 " << rules.tickPeriod << "ms, 初始长度 " << rules.initialLength
+        << ", 最大长度 " << rules.maxLength << ", 每" << rules.bigFoodEvery << "个食物出现大食物("
+        << rules.foodScore[FOOD_BIG] << "分)" << std::endl;
+}
+
+// 从system_config的LEVEL_FILE重新加载关卡，同样只在两局之间调用，下一次Reset时生效
+// 文件只映射一次，路径不变时直接返回；关卡变化时返回true
+bool Game::reloadLevel()
+{
+    std::string path;
+    database.getConfig("LEVEL_FILE", path);
+    if (path == levelPath) {
+        return false;
+    }
+
+    std::shared_ptr<LevelMap> level;
+    if (!path.empty()) {
+        level = std::make_shared<LevelMap>();
+        if (!level->Open(path)) {
+            std::cerr << "无法加载关卡文件: " << path << std::endl;
+            level = nullptr;
+        }
+    }
+    if (!core->SetLevel(level)) {
+        std::cerr << "关卡尺寸与场地不符: " << path << std::endl;
+        core->SetLevel(nullptr);
+        level = nullptr;
+    }
+    levelPath = path;
+    if (level != nullptr) {
+        std::cout << "关卡: " << level->View().Name() << " (" << path << ")" << std::endl;
+    }
+    return true;
+}
+
 void Game::Initialize()
 {
     std::cout << "开始初始化游戏..." << std::endl;
@@ -137,6 +264,7 @@ void Game::Initialize()
         return;
     }
     std::cout << "数据库初始化成功!" << std::endl;
+    reloadRules();
 
     // 生成玩家名并获取玩家ID
     std::cout << "创建玩家..." << std::endl;
@@ -181,15 +309,21 @@ void Game::Initialize()
         FlushBatchDraw();
     }
 
-    // 开始游戏记录
-    std::cout << "开始游戏记录..." << std::endl;
-    currentRecordId = database.startGame(currentPlayerId);
-    std::cout << "游戏记录ID: " << currentRecordId << std::endl;
-
     // 创建蛇和食物
     std::cout << "创建蛇和食物..." << std::endl;
-    snake = std::make_unique<Snake>();
-    SpawnFood();
+    core = std::make_unique<GameCore>(0, StandardBoard(), rules);
+    // 存档订阅者不能丢事件，队列满时暂存到溢出表
+    dbEvents = events.Subscribe("db", EventBit(GameEventType::FOOD_EATEN) | EventBit(GameEventType::DIED)
+        | EventBit(GameEventType::BOARD_FULL), true);
+    renderEvents = events.Subscribe("render", EventBit(GameEventType::GAME_STARTED) | EventBit(GameEventType::FOOD_EATEN));
+    core->SetEventBus(&events);
+    dbThread = std::thread(&Game::dbWorker, this);
+    reloadLevel();
+
+    // 开始游戏记录
+    std::cout << "开始游戏记录..." << std::endl;
+    startNewGame();
+    std::cout << "游戏记录ID: " << currentRecordId.load() << std::endl;
 
     std::cout << "游戏初始化完成! 玩家: " << currentUsername << " (ID: " << currentPlayerId << ")" << std::endl;
 
@@ -206,21 +340,22 @@ void Game::ProcessInput()
     }
 
     //使用GetAsyncKeyState检测按键（非阻塞）
-    if (GetAsyncKeyState('W') & 0x8000 || GetAsyncKeyState(VK_UP) & 0x8000)
+    //每个绘制帧采样一次，按键由松开变为按下时把带时间戳的转向放入队列，由核心在逻辑帧中消耗
+    const bool pressed[4] = {
+        (GetAsyncKeyState('W') & 0x8000) || (GetAsyncKeyState(VK_UP) & 0x8000),
+        (GetAsyncKeyState('S') & 0x8000) || (GetAsyncKeyState(VK_DOWN) & 0x8000),
+        (GetAsyncKeyState('A') & 0x8000) || (GetAsyncKeyState(VK_LEFT) & 0x8000),
+        (GetAsyncKeyState('D') & 0x8000) || (GetAsyncKeyState(VK_RIGHT) & 0x8000)
+    };
+    const Direction dirs[4] = { Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT };
+    const int64_t now = MonotonicMicros();
+    for (int i = 0; i < 4; i++)
     {
-        snake->SetDirection(Direction::UP);
-    }
-    else if (GetAsyncKeyState('S') & 0x8000 || GetAsyncKeyState(VK_DOWN) & 0x8000)
-    {
-        snake->SetDirection(Direction::DOWN);
-    }
-    else if (GetAsyncKeyState('A') & 0x8000 || GetAsyncKeyState(VK_LEFT) & 0x8000)
-    {
-        snake->SetDirection(Direction::LEFT);
-    }
-    else if (GetAsyncKeyState('D') & 0x8000 || GetAsyncKeyState(VK_RIGHT) & 0x8000)
-    {
-        snake->SetDirection(Direction::RIGHT);
+        if (pressed[i] && !keyHeld[i])
+        {
+            input.Push({ now, dirs[i] });   //队列满时丢弃
+        }
+        keyHeld[i] = pressed[i];
     }
 
     //检查ESC键
@@ -230,96 +365,27 @@ void Game::ProcessInput()
     }
 
     //检查R键重开
-    if (gameover && (GetAsyncKeyState('R') & 0x8000))
+    if (core->IsGameOver() && (GetAsyncKeyState('R') & 0x8000))
     {
-        snake->Reset();
-        gameover = false;
-        SpawnFood();
-        if (Bfood != nullptr)
-            Bfood.reset();
-        bigFoodActive = false;
-    }
-}
-
-void Game::SpawnFood()
-{
-    if (food == nullptr && Bfood == nullptr)
-    {
-        food = std::make_unique<Food>(snake);
-    }
-}
-
-void Game::CheckBigFood()
-{
-    if (snake->GetCount() % 4 == 0 && snake->GetCount() > 0 && !bigFoodActive && Bfood == nullptr)
-    {
-        Bfood = std::make_unique<BigFood>(snake);
-        bigFoodActive = true;
-    }
-
-    if (Bfood != nullptr && Bfood->ShouldRemove())
-    {
-        Bfood.reset();
-        snake->setcount();
-        bigFoodActive = false;
-        SpawnFood();
+        flushEvents();
+        reloadRules();
+        reloadLevel();
+        startNewGame();
     }
 }
 
 void Game::Update()
 {
-    if (gameover)
+    if (core->IsGameOver())
     {
-        if (currentRecordId > 0) {
-            database.endGame(currentRecordId,
-                snake->GetScore(),
-                static_cast<int>(snake->getsize()),
-                snake->GetCount(),
-                0,
-                "COMPLETED");
-        }
-
+        // 本局结果由数据库线程按DIED/BOARD_FULL事件写入，这里只等它写完再显示排行榜
+        flushEvents();
         HandleGameOver();
         return;
     }
 
-    CheckBigFood();
-
-    if (food != nullptr && snake->Eat(food))
-    {
-        // 记录食物被吃
-        database.addFoodRecord(currentRecordId, "NORMAL", 1, food->x, food->y);
-        food.reset();
-        CheckBigFood();
-        if (Bfood == nullptr)
-            SpawnFood();
-    }
-    else if (Bfood != nullptr && snake->Eat(Bfood))
-    {
-        // 记录大食物被吃
-        database.addFoodRecord(currentRecordId, "BIG", 5, Bfood->x, Bfood->y);
-        Bfood.reset();
-        bigFoodActive = false;
-        SpawnFood();
-    }
-
-    if (snake->Defeat())
-    {
-        gameover = true;
-
-        if (currentRecordId > 0) {
-            database.endGame(currentRecordId,
-                snake->GetScore(),
-                static_cast<int>(snake->getsize()),
-                snake->GetCount(),
-                0,
-                "FAILED");
-        }
-        return;
-    }
-
-    snake->Move();
-    Sleep(SPEED);
+    // 吃到食物和死亡作为事件投递，由数据库线程写入
+    core->Step(input);
 }
 
 void Game::Render()
@@ -363,19 +429,38 @@ void Game::Render()
     rectangle(0, 0, WIDTH - 1, HEIGHT - 1);
     setlinestyle(PS_SOLID, 1);
 
-    // 先绘制食物（在蛇下面）
-    if (Bfood != nullptr)
-    {
-        Bfood->Show();
-    }
-    else if (food != nullptr)
-    {
-        food->Show();
+    // 关卡的墙
+    if (const LevelView* level = core->GetLevel()) {
+        Renderer::DrawWalls(*level);
     }
 
+    // 先绘制食物（在蛇下面）
+    Renderer::DrawFoods(core->GetFoods());
+
     // 再绘制蛇（在食物上面）
-    snake->Show();
-    snake->showUI();
+    Renderer::DrawSnake(core->GetSnake());
+    Renderer::DrawSnakeUI(core->GetSnake());
+
+    // 吃到食物时在原处飘起分数，新的一局开始时清掉
+    GameEvent event;
+    while (events.Poll(renderEvents, event)) {
+        if (event.type == GameEventType::GAME_STARTED) {
+            popups.clear();
+        }
+        else {
+            popups.push_back({ event.x, event.y, event.value, MonotonicMicros() });
+        }
+    }
+    const int64_t now = MonotonicMicros();
+    for (size_t i = 0; i < popups.size();) {
+        const double progress = (now - popups[i].born) / static_cast<double>(POPUP_MICROS);
+        if (progress >= 1.0) {
+            popups.erase(popups.begin() + i);
+            continue;
+        }
+        Renderer::DrawScorePopup(popups[i].x, popups[i].y, popups[i].score, progress);
+        i++;
+    }
 
     // 显示玩家信息
     settextcolor(WHITE);
@@ -391,6 +476,16 @@ void Game::Render()
     outtextxy(10, HEIGHT - 40, _T("退出: ESC"));
     outtextxy(10, HEIGHT - 20, _T("重新开始: R"));
 
+    // 显示实测逻辑帧率和绘制帧率
+    TCHAR rateInfo[64];
+    _stprintf_s(rateInfo, _T("TPS: %.1f  FPS: %.1f"), timestep.TickRate(), timestep.FrameRate());
+    outtextxy(WIDTH - 160, HEIGHT - 20, rateInfo);
+
+    // 数据库事件的积压
+    TCHAR backlogInfo[64];
+    _stprintf_s(backlogInfo, _T("DB积压: %zu"), events.GetMetrics(dbEvents).backlog);
+    outtextxy(WIDTH - 160, HEIGHT - 40, backlogInfo);
+
     EndBatchDraw();
 }
 
@@ -405,7 +500,7 @@ void Game::HandleGameOver()
     settextcolor(WHITE);
     settextstyle(20, 0, _T("宋体"));
     TCHAR scoreText[50];
-    _stprintf_s(scoreText, _T("最终分数: %d"), snake->GetScore());
+    _stprintf_s(scoreText, _T("最终分数: %d"), core->GetSnake().GetScore());
     outtextxy(WIDTH / 2 - 80, 100, scoreText);
 
     TCHAR playerText[50];
@@ -439,14 +534,9 @@ void Game::HandleGameOver()
 
     while (true) {
         if (GetAsyncKeyState('R') & 0x8000) {
-            snake->Reset();
-            gameover = false;
-            if (Bfood != nullptr)
-                Bfood.reset();
-            bigFoodActive = false;
-
-            currentRecordId = database.startGame(currentPlayerId);
-            SpawnFood();
+            reloadRules();
+            reloadLevel();
+            startNewGame();
             break;
         }
         else if (GetAsyncKeyState('S') & 0x8000) {
@@ -472,16 +562,40 @@ void Game::Run()
     std::cout << "开始游戏主循环..." << std::endl;
 
     int frameCount = 0;
+    timestep.Reset();
     while (!should_break)
     {
         frameCount++;
-        if (frameCount % 100 == 0) {
-            std::cout << "游戏运行中，帧数: " << frameCount << std::endl;
+        if (frameCount % 1000 == 0) {
+            std::cout << "游戏运行中，帧数: " << frameCount
+                << " 逻辑帧率: " << timestep.TickRate()
+                << " 绘制帧率: " << timestep.FrameRate() << std::endl;
+            // 每个事件订阅者的积压（当前/峰值）和丢弃数
+            for (int i = 0; i < events.SubscriberCount(); i++) {
+                const EventBus::Metrics m = events.GetMetrics(i);
+                std::cout << "  事件订阅者 " << m.name << ": 积压 " << m.backlog << "/" << m.peak
+                    << " 已投递 " << m.delivered << " 溢出 " << m.spilled << " 丢弃 " << m.dropped << std::endl;
+            }
         }
 
         try {
             ProcessInput();
-            Update();
+
+            // 按固定步长推进逻辑帧，绘制与逻辑解耦
+            const int ticks = timestep.Advance();
+            for (int i = 0; i < ticks && !should_break; i++) {
+                const bool wasOver = core->IsGameOver();
+                Update();
+                if (wasOver) {
+                    // 结束界面会阻塞等待按键，返回后重新计时，不把等待时间当作积压
+                    timestep.Reset();
+                    break;
+                }
+                if (core->IsGameOver()) {
+                    break;  // 先绘制死亡时的画面
+                }
+            }
+
             Render();
         }
         catch (const std::exception& e) {
@@ -493,8 +607,8 @@ void Game::Run()
             break;
         }
 
-        // 添加帧率控制
-        Sleep(10);
+        // 让出CPU，绘制帧率由绘制耗时决定
+        Sleep(1);
     }
 
     std::cout << "游戏循环结束" << std::endl;
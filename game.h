@@ -1,42 +1,71 @@
 // Game.h - ӿʼ
 #pragma once
-#include "Snake.h"
+#include "GameCore.h"
+#include "Renderer.h"
+#include "FixedTimestep.h"
 #include "AdvancedSQLiteDB.h"
 #include "StartUI.h"  // 
 #include <conio.h>
 #include <string>
 #include <memory>
 #include <random>
+#include <thread>
+#include <atomic>
+#include <vector>
 #include<iostream>
 
 class Game
 {
 private:
-    std::unique_ptr<Snake> snake;
-    std::unique_ptr<Food> food;
-    std::unique_ptr<BigFood> Bfood;
+    std::unique_ptr<GameCore> core;   //޽ϷģGameֻ롢ƺʹ浵
+    InputQueue input;                 //ʱתУδ߼֡
+    bool keyHeld[4];                  //һβʱW/S/A/D()Ƿ£ڼⰴ
+    FixedTimestep timestep;           //߼֡ȣȡsystem_configGAME_SPEED
+    GameRules rules;                  //ǰЧĹ֮system_config¶ȡ
+    std::string levelPath;            //ǰؿļsystem_configLEVEL_FILEΪʱǿճ
+
+    //ķ¼ݿͻƸһ·ݿdbThreadд룬߼֡ȴ
+    EventBus events;
+    int dbEvents;                     //ݿⶩ߱
+    int renderEvents;                 //ƶ߱
+    std::thread dbThread;
+    std::atomic<bool> dbStop;
+    std::atomic<uint64_t> dbHandled;  //ݿ߳Ѵ¼
+
+    //ԵʳʱƮķ
+    struct ScorePopup
+    {
+        int x;
+        int y;
+        int score;
+        int64_t born;                 //ʱ䣨΢룩
+    };
+    std::vector<ScorePopup> popups;
 
     AdvancedSQLiteDB database;
     StartUI startUI;  // 
 
-    bool gameover;
     bool should_break;
-    bool bigFoodActive;
     int currentPlayerId;
-    int currentRecordId;
+    std::atomic<int> currentRecordId;  //ݿ߳Ҳȡ
     std::string currentUsername;
 
     void Initialize();
+    void reloadRules();
+    bool reloadLevel();
     void ProcessInput();
     void Update();
     void Render();
     void HandleGameOver();
-    void SpawnFood();
-    void CheckBigFood();
+    void dbWorker();
+    void flushEvents();
+    void stopEvents();
     void saveGameResult();
     void showGameStatistics();
     void showPlayerStats();
     std::string generatePlayerName();
+    uint64_t newGameSeed();
+    void startNewGame();
 
 public:
     Game();
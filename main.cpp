@@ -4,9 +4,6 @@
 
 int main()
 {
-    // 
-    srand(static_cast<unsigned int>(time(nullptr)));
-
     std::cout << "..." << std::endl;
 
     try {
@@ -1,448 +1,310 @@
 // Snake.cpp - 汾
-#include "Snake.h"
-#include <unordered_set>
-#include <tuple>
+#include "snake.h"
 #include <cmath>
 
-namespace std
+//캯
+template <class B>
+BasicSnake<B>::BasicSnake(const B& board) : board(board), topology(nullptr), walls(nullptr), score(0), count(0), dirt(Direction::RIGHT), length(0),
+node(board.MaxLength()), maxLength(board.MaxLength()), grow(false), hash(0), occupied(board), freeCells(board), selfHit(false), outOfBounds(false), RGB{ 0, 0, 0 }
 {
-    template <>
-    struct hash<tuple<int, int>>
-    {
-        size_t operator()(const tuple<int, int>& key) const
-        {
-            //intϲΪΨһϣֵ
-            const auto& [x, y] = key;
-            return hash<int>()(x) ^ (hash<int>()(y) << 1);
-        }
-    };
-}//ȫػϣ
+}
 
-//캯
-Snake::Snake() : count(0), dirt(Direction::RIGHT), score(0), grow(false)
+template <class B>
+BasicSnake<B>::BasicSnake(CounterRng& colors, const B& board) : BasicSnake(board)
 {
-    Reset();
+    Reset(colors);
 }
 
-void Snake::Reset()
+template <class B>
+void BasicSnake<B>::Reset(CounterRng& colors, int startLength, int maxLength, const SnakeSpawn* spawn)
 {
     node.clear();
-    this->length = 3;
-    SnakeNode temp_node;
-    //±0λΪߵͷ
-    std::mt19937 gen(std::random_device{}());
-    std::uniform_int_distribution<> dis(50, 200);
-
-    for (int i = 0; i < length; i++)
+    occupied.Clear();
+    freeCells.Clear();
+    hash = 0;
+    //󳤶ȲֳȲ󳤶
+    const int capacity = static_cast<int>(node.capacity());
+    this->maxLength = maxLength > 0 && maxLength < capacity ? maxLength : capacity;
+    int want = startLength < 1 ? 1 : startLength;
+    if (want > this->maxLength)
+        want = this->maxLength;
+
+    //±0λΪߵͷĬλڵ3С0~length-1У
+    SnakeSpawn start = { want - 1, 3, Direction::RIGHT };
+    if (spawn != nullptr)
+        start = *spawn;
+    //ͷķſ߽ؿǽʱض̣ؿļֻ֤Ĭϳȵǽϣ
+    const int bx = -TOPOLOGY_DX[static_cast<int>(start.dir)];
+    const int by = -TOPOLOGY_DY[static_cast<int>(start.dir)];
+    for (int i = 0; i < want; i++)
+    {
+        const int gx = start.x + bx * i;
+        const int gy = start.y + by * i;
+        if (!board.Contains(gx, gy))
+            break;
+        const Cell cell = static_cast<Cell>(board.CellAt(gx, gy));
+        if (i > 0 && IsLevelWall(static_cast<int64_t>(cell)))
+            break;
+        this->node.push_back(cell);
+        Occupy(cell);
+    }
+    this->length = static_cast<int>(node.size());
+    //ǽԶУʳﲻǽ
+    if (topology != nullptr)
+    {
+        for (const Cell wall : topology->Walls())
+        {
+            if (freeCells.IsFree(wall))
+                freeCells.Take(wall);
+        }
+    }
+    for (int i = 0; i < 3; i++)
     {
-        temp_node.x = 60 - ((i + 1) * MYSIZE);
-        temp_node.y = 60;
-        temp_node.RGB[0] = dis(gen);
-        temp_node.RGB[1] = dis(gen);
-        temp_node.RGB[2] = dis(gen);
-        temp_node.pulseOffset = i * 10; // ÿڵвͬƫ
-        this->node.emplace_back(temp_node);
+        RGB[i] = colors.Range(50, 200);
     }
 
     count = 0;
-    dirt = Direction::RIGHT;
+    dirt = start.dir;
     score = 0;
     grow = false;
+    selfHit = false;
+    outOfBounds = false;
+    hash ^= ZobristKey(ZOBRIST_HEAD, node[0]) ^ ZobristDirection(dirt);
 }
 
-void Snake::setcount()
+template <class B>
+void BasicSnake<B>::setcount()
 {
     this->count = 0;
 }
 
-size_t Snake::getsize()
+template <class B>
+size_t BasicSnake<B>::getsize() const
 {
     return this->node.size();
 }
 
-//ƶ
-void Snake::Move()
+template <class B>
+SnakeNode BasicSnake<B>::GetNode(size_t i) const
 {
-    //浱ǰͷλ
-    SnakeNode head = node[0];
-
-    // ݷƶͷ
-    switch (dirt)
-    {
-    case Direction::UP:
-        head.y -= MYSIZE;
-        break;
-    case Direction::DOWN:
-        head.y += MYSIZE;
-        break;
-    case Direction::LEFT:
-        head.x -= MYSIZE;
-        break;
-    case Direction::RIGHT:
-        head.x += MYSIZE;
-        break;
-    }
-
-    //ͷµĽڵ
-    node.insert(node.begin(), head);
-
-    //Ҫɾβڵ
-    if (!grow)
-    {
-        node.pop_back();
-    }
-    else
-    {
-        grow = false;//־
-        length++;//ӳ
-    }
+    return { board.Col(node[i]) * MYSIZE, board.Row(node[i]) * MYSIZE };
 }
 
-//÷
-void Snake::SetDirection(Direction newDir)
+template <class B>
+typename BasicSnake<B>::Cell BasicSnake<B>::GetHeadCell() const
 {
-    // ֹƶ
-    if ((dirt == Direction::UP && newDir == Direction::DOWN) ||
-        (dirt == Direction::DOWN && newDir == Direction::UP) ||
-        (dirt == Direction::LEFT && newDir == Direction::RIGHT) ||
-        (dirt == Direction::RIGHT && newDir == Direction::LEFT))
-    {
-        return;
-    }
-    dirt = newDir;
+    return node[0];
 }
 
-//ʧж
-bool Snake::Defeat() const
+template <class B>
+typename BasicSnake<B>::Cell BasicSnake<B>::GetCell(size_t i) const
 {
-    //߽
-    if (this->node[0].x < 0 || this->node[0].x >= WIDTH ||
-        this->node[0].y < 0 || this->node[0].y >= HEIGHT)
-    {
-        return true;
-    }
+    return node[i];
+}
 
-    //Լ
-    for (size_t i = 1; i < this->node.size(); i++)
-    {
-        if (this->node[0].x == this->node[i].x && this->node[0].y == this->node[i].y)
-        {
-            return true;
-        }
-    }
+template <class B>
+bool BasicSnake<B>::IsGrowing() const
+{
+    return grow && node.size() < static_cast<size_t>(maxLength);
+}
 
-    return false;
+template <class B>
+const int* BasicSnake<B>::GetColor() const
+{
+    return RGB;
 }
 
-void Snake::showUI()
+template <class B>
+const B& BasicSnake<B>::GetBoard() const
 {
-    //ӡѾõķ
-    settextcolor(WHITE);
-    setbkmode(TRANSPARENT);
-    settextstyle(16, 0, _T(""));
-    outtextxy(WIDTH - 120, 10, _T(":"));
-    TCHAR scoreStr[10];
-    _stprintf_s(scoreStr, _T("%d"), this->score);
-    outtextxy(WIDTH - 50, 10, scoreStr);
-
-    // ʾ
-    outtextxy(WIDTH - 120, 35, _T(":"));
-    TCHAR lengthStr[10];
-    _stprintf_s(lengthStr, _T("%zu"), this->node.size());
-    outtextxy(WIDTH - 50, 35, lengthStr);
+    return board;
 }
 
-int Snake::GetCount() const
+template <class B>
+void BasicSnake<B>::SetTopology(const BasicTopology<B>* topology)
 {
-    return this->count;
+    this->topology = topology;
 }
 
-int Snake::GetScore() const
+template <class B>
+const BasicTopology<B>* BasicSnake<B>::GetTopology() const
 {
-    return this->score;
+    return topology;
 }
 
-Food::Food(const std::unique_ptr<Snake>& snake)
+template <class B>
+void BasicSnake<B>::SetWalls(const uint64_t* walls)
 {
-    this->score = 1;
+    this->walls = walls;
+}
 
-    std::unordered_set<std::tuple<int, int>> snakePositions;
-    for (const auto& node : snake->node)
-    {
-        snakePositions.emplace(node.x, node.y);
-    }
+//ӱؿǽռ
+template <class B>
+bool BasicSnake<B>::Blocked(Cell cell) const
+{
+    return occupied.Test(cell) || IsLevelWall(static_cast<int64_t>(cell));
+}
 
-    //ʹþ̬ظʼ
-    static std::mt19937 gen(std::random_device{}());
-    const int gridWidth = WIDTH / MYSIZE;
-    const int gridHeight = HEIGHT / MYSIZE;
+template <class B>
+const BasicOccupancy<B>& BasicSnake<B>::GetOccupancy() const
+{
+    return this->occupied;
+}
 
-    std::uniform_int_distribution<int> disX(1, gridWidth - 2);//BigFood-X
-    std::uniform_int_distribution<int> disY(1, gridHeight - 2);//BigFood-Y
+template <class B>
+const BasicFreeCells<B>& BasicSnake<B>::GetFreeCells() const
+{
+    return this->freeCells;
+}
 
-    //޴γԻ
-    constexpr int MAX_ATTEMPTS = 1000;
-    int attempts = 0;
+//ռһӣͬλͼͿиԭѱռʱfalse
+template <class B>
+bool BasicSnake<B>::Occupy(Cell cell)
+{
+    if (occupied.Test(cell))
+        return false;
+    occupied.Set(cell);
+    freeCells.Take(cell);
+    hash ^= ZobristKey(ZOBRIST_BODY, cell);
+    return true;
+}
 
-    do
-    {
-        //תΪ
-        const int gridX = disX(gen);
-        const int gridY = disY(gen);
-        this->x = gridX * MYSIZE;
-        this->y = gridY * MYSIZE;
+//ͷһ
+template <class B>
+void BasicSnake<B>::Vacate(Cell cell)
+{
+    if (!occupied.Test(cell))
+        return;
+    occupied.Reset(cell);
+    freeCells.Release(cell);
+    hash ^= ZobristKey(ZOBRIST_BODY, cell);
+}
 
-        if (++attempts > MAX_ATTEMPTS)
-        {
-            throw std::runtime_error("ʳʧܣܵͼ");
-        }
-    } while (snakePositions.count({ x, y }) > 0);//ʹùϣʵO(1)ӶȲѯ
+template <class B>
+void BasicSnake<B>::SetGrow(bool value)
+{
+    if (grow != value)
+        hash ^= ZobristGrow();
+    grow = value;
 }
 
-void Snake::Show()
+//ƶ
+template <class B>
+void BasicSnake<B>::Move()
 {
-    // ʹʱЧ
-    auto now = std::chrono::steady_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+    //һʱһβ桢ǽŶ
+    const int64_t target = topology != nullptr ? static_cast<int64_t>(topology->Next(node[0], dirt)) : StepRect(board, node[0], dirt);
 
-    // 
-    for (size_t i = 0; i < node.size(); i++)
+    //ײǽʱֲDefeatиؿǽֱӶӳеλͼ
+    if (target < 0 || IsLevelWall(target))
     {
-        // Ч
-        double pulse = sin((ms + node[i].pulseOffset) * 0.01) * 0.1 + 0.9;
-
-        // ɫ䣺ͷβ𽥱䰵
-        double alpha = 1.0 - (i * 0.7 / node.size());
-        if (alpha < 0.3) alpha = 0.3;
-
-        COLORREF segmentColor = RGB(
-            static_cast<int>(node[i].RGB[0] * alpha * pulse),
-            static_cast<int>(node[i].RGB[1] * alpha * pulse),
-            static_cast<int>(node[i].RGB[2] * alpha * pulse)
-        );
-
-        setfillcolor(segmentColor);
-        setlinecolor(RGB(255, 255, 255));  // ɫ߿߸
-
-        // Сͷ
-        int size = MYSIZE;
-        if (i == 0) {
-            size = static_cast<int>(MYSIZE * 1.2); // ͷ
-        }
-        else {
-            size = static_cast<int>(MYSIZE * (1.0 - i * 0.1 / node.size()));
-            if (size < MYSIZE * 0.7) size = static_cast<int>(MYSIZE * 0.7);
-        }
-
-        // ԲǾΪ
-        int offset = (MYSIZE - size) / 2;
-        fillroundrect(
-            node[i].x + offset,
-            node[i].y + offset,
-            node[i].x + MYSIZE - offset,
-            node[i].y + MYSIZE - offset,
-            8, 8
-        );
-
-        // Ʊ߿
-        setlinecolor(RGB(255, 255, 255));
-        roundrect(
-            node[i].x + offset,
-            node[i].y + offset,
-            node[i].x + MYSIZE - offset,
-            node[i].y + MYSIZE - offset,
-            8, 8
-        );
+        outOfBounds = true;
+        return;
     }
 
-    // ͷ۾- ֲ
-    if (!node.empty()) {
-        // ݷȷ۾λ
-        int eyeSize = MYSIZE / 5;
-        int eyeOffset = MYSIZE / 3;
+    const Cell oldHead = node[0];
 
-        POINT leftEye, rightEye;
+    //ҪѴ󳤶ȣɾβڵ
+    if (!grow || node.size() >= static_cast<size_t>(maxLength))
+    {
+        Vacate(node.back());
+        node.pop_back();
+    }
+    else
+    {
+        length++;//ӳ
+    }
+    SetGrow(false);//־
 
-        switch (dirt) {
-        case Direction::UP:
-            leftEye = { node[0].x + eyeOffset, node[0].y + eyeOffset };
-            rightEye = { node[0].x + MYSIZE - eyeOffset, node[0].y + eyeOffset };
-            break;
-        case Direction::DOWN:
-            leftEye = { node[0].x + eyeOffset, node[0].y + MYSIZE - eyeOffset };
-            rightEye = { node[0].x + MYSIZE - eyeOffset, node[0].y + MYSIZE - eyeOffset };
-            break;
-        case Direction::LEFT:
-            leftEye = { node[0].x + eyeOffset, node[0].y + eyeOffset };
-            rightEye = { node[0].x + eyeOffset, node[0].y + MYSIZE - eyeOffset };
-            break;
-        case Direction::RIGHT:
-            leftEye = { node[0].x + MYSIZE - eyeOffset, node[0].y + eyeOffset };
-            rightEye = { node[0].x + MYSIZE - eyeOffset, node[0].y + MYSIZE - eyeOffset };
-            break;
-        }
+    //ͷµĽڵ㣬λֻƶͷ±꣬
+    const Cell head = static_cast<Cell>(target);
+    hash ^= ZobristKey(ZOBRIST_HEAD, oldHead) ^ ZobristKey(ZOBRIST_HEAD, head);
+    node.push_front(head);
 
-        // ۾
-        setfillcolor(RGB(255, 255, 255));
-        solidcircle(leftEye.x, leftEye.y, eyeSize);
-        solidcircle(rightEye.x, rightEye.y, eyeSize);
+    //βóʱͷڸԱռüΪײԼ
+    selfHit = !Occupy(head);
+}
 
-        setfillcolor(RGB(0, 0, 0));
-        solidcircle(leftEye.x, leftEye.y, eyeSize / 2);
-        solidcircle(rightEye.x, rightEye.y, eyeSize / 2);
+//÷
+template <class B>
+bool BasicSnake<B>::SetDirection(Direction newDir)
+{
+    // ֹƶͬҲת
+    if (newDir == dirt || IsReverse(dirt, newDir))
+    {
+        return false;
     }
+    hash ^= ZobristDirection(dirt) ^ ZobristDirection(newDir);
+    dirt = newDir;
+    return true;
 }
 
-Food::~Food()
+//ʧж
+template <class B>
+bool BasicSnake<B>::Defeat() const
 {
+    //߽Լ壺Moveƶʱ
+    return outOfBounds || selfHit;
 }
 
-BigFood::BigFood(const std::unique_ptr<Snake>& snake)
+template <class B>
+bool BasicSnake<B>::HitWall() const
 {
-    this->score = 5;
-    this->spawnTime = std::chrono::steady_clock::now();
-
-    std::unordered_set<std::tuple<int, int>> snakePositions;
-    for (const auto& node : snake->node)
-    {
-        snakePositions.emplace(node.x, node.y);//ֱӲԪ
-    }
-
-    //ʹþ̬ظʼ
-    static std::mt19937 gen(std::random_device{}());
-    const int gridWidth = WIDTH / MYSIZE;
-    const int gridHeight = HEIGHT / MYSIZE;
-
-    std::uniform_int_distribution<int> disX(0, gridWidth - 1);
-    std::uniform_int_distribution<int> disY(0, gridHeight - 1);
-
-    //޴γԻ
-    constexpr int MAX_ATTEMPTS = 1000;
-    int attempts = 0;
-
-    do
-    {
-        //תΪ
-        const int gridX = disX(gen);
-        const int gridY = disY(gen);
-        this->x = gridX * MYSIZE;
-        this->y = gridY * MYSIZE;
-
-        if (++attempts > MAX_ATTEMPTS)
-        {
-            throw std::runtime_error("BigFoodʧܣܵͼ");
-        }
-    } while (snakePositions.count({ x, y }) > 0);//ʹùϣʵO(1)ӶȲѯ
+    return outOfBounds;
 }
 
-void BigFood::Show()
+template <class B>
+bool BasicSnake<B>::HitSelf() const
 {
-    // ʹʱ˸Ч
-    auto now = std::chrono::steady_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-
-    // ǿҵЧ
-    double pulse = sin(ms * 0.015) * 0.3 + 0.7;
-
-    // ɫɫ
-    COLORREF baseColor = RGB(255, 215, 0);
-    COLORREF currentColor = RGB(
-        static_cast<int>(GetRValue(baseColor) * pulse),
-        static_cast<int>(GetGValue(baseColor) * pulse),
-        static_cast<int>(GetBValue(baseColor) * pulse)
-    );
-
-    setfillcolor(currentColor);
-    setlinecolor(RGB(255, 255, 255));
-
-    // ƴʳ壨״
-    int centerX = this->x + MYSIZE / 2;
-    int centerY = this->y + MYSIZE / 2;
-    int outerRadius = static_cast<int>(MYSIZE * 0.5 * pulse);
-    int innerRadius = static_cast<int>(outerRadius * 0.4);
-
-    // 
-    POINT points[10];
-    for (int i = 0; i < 10; i++) {
-        double angle = i * 3.14159 / 5 - 3.14159 / 2;
-        int radius = (i % 2 == 0) ? outerRadius : innerRadius;
-        points[i].x = centerX + static_cast<int>(radius * cos(angle));
-        points[i].y = centerY + static_cast<int>(radius * sin(angle));
-    }
-
-    solidpolygon(points, 10);
-
-    // ӷЧ
-    setlinecolor(RGB(255, 255, 0));
-    setlinestyle(PS_SOLID, 2);
-    for (int i = 0; i < 5; i++) {
-        double angle = i * 2 * 3.14159 / 5 - 3.14159 / 2;
-        int endX = centerX + static_cast<int>((outerRadius + 5) * cos(angle));
-        int endY = centerY + static_cast<int>((outerRadius + 5) * sin(angle));
-        line(centerX, centerY, endX, endY);
-    }
-    setlinestyle(PS_SOLID, 1);
+    return selfHit;
 }
 
-BigFood::~BigFood()
+template <class B>
+uint64_t BasicSnake<B>::Hash() const
 {
+    return hash;
 }
 
-bool BigFood::ShouldRemove() const
+//ײʱͷĳͬռλͼֻһΣֻͬһ
+template <class B>
+uint64_t BasicSnake<B>::ComputeHash() const
 {
-    auto now = std::chrono::steady_clock::now();//ȡǰʱ
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - spawnTime).count();//ʱ
-    return duration > BIGFOOD_DURATION;
+    uint64_t h = ZobristKey(ZOBRIST_HEAD, node[0]) ^ ZobristDirection(dirt);
+    if (grow)
+        h ^= ZobristGrow();
+    BasicOccupancy<B> seen(board);
+    for (size_t i = 0; i < node.size(); i++)
+    {
+        if (!seen.Test(node[i]))
+        {
+            seen.Set(node[i]);
+            h ^= ZobristKey(ZOBRIST_BODY, node[i]);
+        }
+    }
+    return h;
 }
 
-BaseFood::BaseFood() : score(0), x(0), y(0)
+template <class B>
+int BasicSnake<B>::GetCount() const
 {
+    return this->count;
 }
 
-SnakeNode::SnakeNode() : x(0), y(0), pulseOffset(0)
+template <class B>
+int BasicSnake<B>::GetScore() const
 {
-    for (size_t i = 0; i < 3; ++i)
-        this->RGB[i] = 0;
+    return this->score;
 }
 
-void Food::Show()
+template <class B>
+Direction BasicSnake<B>::GetDirection() const
 {
-    // ʹʱ˸Ч
-    auto now = std::chrono::steady_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-
-    // Ч
-    double pulse = sin(ms * 0.01) * 0.2 + 0.8;
-
-    // ɫƻ죩
-    COLORREF baseColor = RGB(255, 50, 50);
-    COLORREF currentColor = RGB(
-        static_cast<int>(GetRValue(baseColor) * pulse),
-        static_cast<int>(GetGValue(baseColor) * pulse),
-        static_cast<int>(GetBValue(baseColor) * pulse)
-    );
-
-    setfillcolor(currentColor);
-    setlinecolor(RGB(255, 255, 255));
-
-    // ʳ壨ԲΣ
-    int centerX = this->x + MYSIZE / 2;
-    int centerY = this->y + MYSIZE / 2;
-    int radius = static_cast<int>(MYSIZE * 0.4 * pulse);
-
-    solidcircle(centerX, centerY, radius);
-
-    // Ƹ߹
-    setfillcolor(RGB(255, 255, 255));
-    solidcircle(centerX - radius / 3, centerY - radius / 3, radius / 4);
-
-    // ƾ
-    setlinecolor(RGB(100, 200, 100));
-    setlinestyle(PS_SOLID, 2);
-    line(centerX, centerY - radius, centerX, centerY - radius - 5);
-    setlinestyle(PS_SOLID, 1);
-
-    // Ҷ
-    setfillcolor(RGB(100, 200, 100));
-    solidcircle(centerX + 2, centerY - radius - 3, 3);
-}
\ No newline at end of file
+    return this->dirt;
+}
+
+//ʽʵ̳ߴʱsnake.hиһ
+template class BasicSnake<TinyBoard>;
+template class BasicSnake<StandardBoard>;
+template class BasicSnake<LargeBoard>;
+template class BasicSnake<DynamicBoard>;
+template class BasicSnake<SparseBoard>;
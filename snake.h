@@ -1,101 +1,113 @@
 #pragma once
-#include "common.h"
-#include <graphics.h>
-#include <Windows.h>
+//ĿͷļֻϷ߼EasyX/WindowsƼRenderer.h
+#include "GameDefs.h"
+#include "SnakeBody.h"
+#include "SparseGrid.h"
+#include "Topology.h"
+#include "GameRng.h"
+#include "Zobrist.h"
 #include <stdlib.h>
-#include <string>
-#include <vector>
-#include <random>
+#include <cstdint>
 #include <stdexcept>
-#include <functional>
-#include <chrono>
-class Snake;
-// Snake.h޸SnakeNode
-class SnakeNode
+//һڵ꣬ɸӱŻõֻڶȡ
+struct SnakeNode
 {
-public:
-    int x{ 0 };
-    int y{ 0 };
-    int RGB[3];
-    int pulseOffset; // Чƫ
-    SnakeNode();
+    int x;
+    int y;
 };
-//ߵ
-class Snake
+//ʱͷλúͳ
+struct SnakeSpawn
 {
-    friend class Food;
-    friend class BigFood;
+    int x;
+    int y;
+    Direction dir;
+};
+
+//ߵ࣬BΪͣBoard.h
+//СгԱǶ߿԰ֽڸƣGameState
+template <class B>
+class BasicSnake
+{
+public:
+    using Cell = typename B::Cell;
 
 private:
+    B board;                    //
+    const BasicTopology<B>* topology;   //һұGameCoreУnullptrʱα߽
+    const uint64_t* walls;      //ؿǽλͼӳĹؿļУûйؿʱΪnullptr
     int score;                  //
     int count;                  //жϴʳ
     Direction dirt;             //ߵĳ
     int length;                 //        оҪڣΪ˳ʼ㻹  node.size()=lengthʵ
-    std::vector<SnakeNode> node; //ߵĽ
+    SnakeBody<typename B::template Storage<Cell, B::CELLS>> node; //ߵĽ㣨ӱţ
+    int maxLength;              //ﵽ
     bool grow;                  //ǷҪ
+    uint64_t hash;              //ͷʹZobristϣƶά
+    BasicOccupancy<B> occupied; //ռλͼMoveά
+    BasicFreeCells<B> freeCells;//иoccupiedͬά
+    bool selfHit;               //һƶǷײԼ
+    bool outOfBounds;           //һƶǷײǽǽ񣬴ʱֲ
+    int RGB[3];                 //ɫ
+    bool Occupy(Cell cell);
+    void Vacate(Cell cell);
+    void SetGrow(bool value);
+    bool IsLevelWall(int64_t cell) const { return walls != nullptr && ((walls[cell >> 6] >> (cell & 63)) & 1); }
 public:
-    Snake();                                    //ʼ
-    template <class T>
-    bool Eat(const std::unique_ptr<T>& food);   //ʳ
+    explicit BasicSnake(const B& board = B());  //ߣٵReset
+    explicit BasicSnake(CounterRng& colors, const B& board = B()); //ʼɫȡɫ
+    template <class Pool>
+    int Eat(const Pool& foods);                 //ͷڸʳʳе±꣬ûʱΪ-1
     void Move();                                //ƶ
-    void Show();                                //
     bool Defeat() const;                        //ʧж
-    void showUI();                              //ӡUI
+    bool HitWall() const;                       //иԭ򣺳
+    bool HitSelf() const;                       //иԭײԼ
     int GetCount() const;
     int GetScore() const;
-    void SetDirection(Direction newDir);        //÷
-    void Reset();                               //
+    Direction GetDirection() const;
+    uint64_t Hash() const;                      //άZobristϣ
+    uint64_t ComputeHash() const;               //ͷĹϣУ
+    SnakeNode GetNode(size_t i) const;          //±0Ϊͷ
+    Cell GetHeadCell() const;
+    Cell GetCell(size_t i) const;               //iڵĸӣ±0Ϊͷ
+    bool IsGrowing() const;                     //ճԵʳһƶʱβó
+    const int* GetColor() const;                //RGB
+    const B& GetBoard() const;
+    void SetTopology(const BasicTopology<B>* topology); //һResetǰãResetʱǽӿиų
+    const BasicTopology<B>* GetTopology() const;    //ûʱΪnullptr
+    void SetWalls(const uint64_t* walls);       //ؿǽλͼӱΪy*+xֻڳ
+    bool Blocked(Cell cell) const;              //ӱؿǽռݣAIѯ
+    bool SetDirection(Direction newDir);        //÷򣬷ıʱtrue
+    //ߣmaxLengthΪ0ʱֻƣspawnΪnullptrʱĬλó
+    void Reset(CounterRng& colors, int startLength = START_LENGTH, int maxLength = 0, const SnakeSpawn* spawn = nullptr);
     void setcount();
-    size_t getsize();
-};
-
-class BaseFood
-{
-public:
-    int x, y;
-    int score; // 
-    BaseFood();
-    virtual ~BaseFood() = default;
-    virtual void Show() {};
-    virtual bool ShouldRemove() const { return false; };
+    size_t getsize() const;
+    const BasicOccupancy<B>& GetOccupancy() const;  //ʳɡAIѯռ
+    const BasicFreeCells<B>& GetFreeCells() const;  //и
 };
 
-// ʳ
-class Food : public BaseFood
-{
-    friend class Snake;
+//Աsnake.cppУг̳ߴʽʵ
+extern template class BasicSnake<TinyBoard>;
+extern template class BasicSnake<StandardBoard>;
+extern template class BasicSnake<LargeBoard>;
+extern template class BasicSnake<DynamicBoard>;
+extern template class BasicSnake<SparseBoard>;
 
-public:
-    Food(const std::unique_ptr<Snake>& snake);
-    void Show() override; //ʳ
-    ~Food();
-};
-
-class BigFood : public BaseFood
-{
-    friend class Snake;
-private:
-    std::chrono::steady_clock::time_point spawnTime; //ʱ
-
-public:
-    BigFood(const std::unique_ptr<Snake>& snake);
-    void Show() override; //ʳ
-    ~BigFood();
-    bool ShouldRemove() const override; //ǷӦƳ
-};
+using Snake = BasicSnake<StandardBoard>;
 
 //ģ庯ĶͨҪͷļнжԴļ
 //Ϊģʵڱʱе
 //ұҪģԱΪض͵Ĳɴ
-template <class T>
-bool Snake::Eat(const std::unique_ptr<T>& food)
+//ʳؼFoodPool.hͷӲһ񼴿ɣʳ޹
+template <class B>
+template <class Pool>
+int BasicSnake<B>::Eat(const Pool& foods)
 {
-    if (food->x == this->node[0].x && food->y == this->node[0].y)
+    const int i = foods.Find(this->node[0]);
+    if (i >= 0)
     {
-        this->score += food->score;
+        this->score += foods.ValueAt(i);
         this->count++;
-        this->grow = true; //Ҫ
-        return true;
+        SetGrow(true); //Ҫ
     }
-    return false;
-}
\ No newline at end of file
+    return i;
+}
@@ -0,0 +1,156 @@
+﻿// BatchSimTest.cpp - 批量模拟器与GameCore逐帧对照：同样的转向下，蛇头、长度、分数、食物和死亡的帧都应相同
+// 两边从空闲格中抽取食物位置的顺序不同，所以每帧结束后把GameCore的食物挪到BatchSim抽中的格子，只对照规则本身
+// 在仓库根目录编译运行：g++ -O2 -std=c++17 -pthread -I. tests/BatchSimTest.cpp BatchSim.cpp BatchKernels.cpp ParallelFor.cpp GameCore.cpp snake.cpp LevelFile.cpp && ./a.out
+#include "BatchSim.h"
+#include "GameCore.h"
+#include <iostream>
+#include <memory>
+#include <vector>
+
+static int failures = 0;
+
+static void Check(bool ok, const char* what)
+{
+    std::cout << (ok ? "通过  " : "失败  ") << what << std::endl;
+    if (!ok)
+        failures++;
+}
+
+//GameCore中该种类食物的下标，没有时为-1
+static int FindKind(const FoodPool& foods, uint8_t kind)
+{
+    for (int i = 0; i < foods.Count(); i++)
+    {
+        if (foods.KindAt(i) == kind)
+            return i;
+    }
+    return -1;
+}
+
+//把core的食物挪到batch第g局的位置；食物只会在本帧出现，大食物的过期按本帧重新登记
+//两边同一种类的食物一边有一边没有时返回false
+static bool SyncFoods(const BatchSim& batch, int g, GameCore& core, GameState& state)
+{
+    core.Snapshot(state);
+    int want[FOOD_KINDS];
+    bool moved = false;
+    for (uint8_t kind = 0; kind < FOOD_KINDS; kind++)
+    {
+        want[kind] = batch.GetFoodCell(g, kind);
+        const int i = FindKind(state.foods, kind);
+        if ((i >= 0) != (want[kind] >= 0))
+            return false;
+        if (i >= 0 && state.foods.CellAt(i) != want[kind])
+        {
+            state.timers.Cancel(state.foods.ExpiryAt(i));
+            state.foods.Remove(i);
+            moved = true;
+        }
+    }
+    if (!moved)
+        return true;
+    //先全部移走再放回，避免新位置正好是另一种食物的旧位置
+    for (uint8_t kind = 0; kind < FOOD_KINDS; kind++)
+    {
+        if (want[kind] < 0 || FindKind(state.foods, kind) >= 0)
+            continue;
+        const int i = state.foods.Add(static_cast<CellIndex>(want[kind]), kind, state.rules.foodScore[kind]);
+        if (i < 0)
+            return false;
+        if (state.rules.foodLifetime[kind] > 0)
+        {
+            state.foods.SetExpiry(i, state.timers.Schedule(state.tick + state.rules.foodLifetime[kind] + 1, TIMER_FOOD_EXPIRE,
+                static_cast<uint64_t>(want[kind])));
+        }
+    }
+    core.Restore(state);
+    return true;
+}
+
+//GAMES局各推进TICKS帧，某一局结束后GameCore也重开，继续对照BatchSim在该槽位的下一局
+static bool RunLockstep(const GameRules& rules, BatchPolicy policy, int turnPercent, int& deaths, int& eaten)
+{
+    constexpr int GAMES = 32;
+    constexpr int TICKS = 4000;
+    BatchSim batch(GAMES, 2024, BATCH_MAX_LENGTH, rules);
+    batch.UsePolicy(policy);
+    GameRules coreRules = rules;
+    coreRules.maxLength = BATCH_MAX_LENGTH;
+    std::vector<std::unique_ptr<GameCore>> cores;
+    std::vector<InputQueue> inputs(GAMES);
+    auto state = std::make_unique<GameState>();
+    for (int g = 0; g < GAMES; g++)
+    {
+        cores.push_back(std::make_unique<GameCore>(g, StandardBoard(), coreRules));
+        if (!SyncFoods(batch, g, *cores[g], *state))
+            return false;
+    }
+
+    for (int t = 0; t < TICKS; t++)
+    {
+        batch.Step(turnPercent);
+        for (int g = 0; g < GAMES; g++)
+        {
+            GameCore& core = *cores[g];
+            if (core.IsGameOver())
+            {
+                core.Reset(static_cast<uint64_t>(t) * GAMES + g);
+                inputs[g].Clear();
+            }
+            //BatchSim本帧已转向，把转向后的方向作为GameCore本帧的输入
+            inputs[g].Push({ static_cast<int>(core.GetTick()), batch.GetDirection(g) });
+            const int scoreBefore = core.GetSnake().GetScore();
+            core.Step(inputs[g]);
+            if (core.GetSnake().GetScore() != scoreBefore)
+                eaten++;
+            if (!SyncFoods(batch, g, core, *state))
+                return false;
+
+            const Snake& snake = core.GetSnake();
+            if (snake.GetHeadCell() != batch.GetHeadCell(g) || static_cast<int>(snake.getsize()) != batch.GetLength(g)
+                || snake.GetScore() != batch.GetScore(g) || snake.GetDirection() != batch.GetDirection(g)
+                || snake.Defeat() != batch.Died(g))
+            {
+                std::cout << "  第" << g << "局第" << core.GetTick() << "帧不一致" << std::endl;
+                return false;
+            }
+            if (batch.Died(g))
+            {
+                deaths++;
+                //GameCore在下一帧开始时才判负，这里直接推进一帧让它结束
+                core.Step(inputs[g]);
+                if (!core.IsGameOver())
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    int deaths = 0;
+    int eaten = 0;
+    Check(RunLockstep(GameRules(), BatchPolicy::RANDOM, 12, deaths, eaten) && deaths > 0 && eaten > 0, "默认规则下随机转向与GameCore逐帧一致");
+
+    //每吃一个就出现大食物、很快过期：覆盖大食物的出现、被吃和过期
+    GameRules busy;
+    busy.bigFoodEvery = 1;
+    busy.foodLifetime[FOOD_BIG] = 20;
+    deaths = 0;
+    eaten = 0;
+    Check(RunLockstep(busy, BatchPolicy::RANDOM, 12, deaths, eaten) && deaths > 0 && eaten > 0, "频繁出现大食物时与GameCore逐帧一致");
+
+    //不转向：所有局都直接撞墙，覆盖出界时蛇身不动
+    deaths = 0;
+    eaten = 0;
+    Check(RunLockstep(GameRules(), BatchPolicy::RANDOM, 0, deaths, eaten) && deaths > 0, "不转向时与GameCore在同一帧撞墙");
+
+    //贪心策略：吃得多、蛇身长到容量上限，覆盖达到最大长度后不再增长
+    deaths = 0;
+    eaten = 0;
+    Check(RunLockstep(GameRules(), BatchPolicy::BOT, 0, deaths, eaten) && eaten > 1000, "贪心策略下与GameCore逐帧一致");
+
+    std::cout << (failures == 0 ? "全部通过" : "有测试失败") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+﻿// LevelFileTest.cpp - 关卡文件校验的测试：合法文件能加载，各种损坏的文件都被LevelView::Attach拒绝
+// 损坏的样本由一个合法关卡编码后逐项改坏得到，不依赖磁盘上的文件
+// 在仓库根目录编译运行：g++ -O2 -std=c++17 -pthread -I. tests/LevelFileTest.cpp LevelFile.cpp LevelGen.cpp ParallelFor.cpp GameCore.cpp snake.cpp && ./a.out
+#include "LevelFile.h"
+#include "LevelGen.h"
+#include "GameCore.h"
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+static int failures = 0;
+
+static void Check(bool ok, const char* what)
+{
+    std::cout << (ok ? "通过  " : "失败  ") << what << std::endl;
+    if (!ok)
+        failures++;
+}
+
+//16x8的小关卡：第5列中间一段墙，出生点在(8, 3)朝右，开局蛇身的最后一节紧挨着墙，其余空地都可生成食物
+static LevelData SampleLevel()
+{
+    LevelData level(16, 8);
+    level.name = "sample";
+    for (int y = 2; y < 6; y++)
+        level.SetWall(5, y, true);
+    for (int y = 0; y < level.height; y++)
+    {
+        for (int x = 0; x < level.width; x++)
+        {
+            if (!level.IsWall(x, y))
+                level.SetFood(x, y, true);
+        }
+    }
+    level.AddSpawn(8, 3, Direction::RIGHT);
+    return level;
+}
+
+static bool Loads(const std::vector<uint8_t>& bytes)
+{
+    LevelMap map;
+    return map.Adopt(bytes);
+}
+
+//把编码后的文件按mutate改坏，返回能否加载
+static bool LoadsAfter(const std::function<void(LevelHeader&, uint64_t* walls, uint64_t* food, LevelSpawn* spawns)>& mutate)
+{
+    std::vector<uint8_t> bytes = EncodeLevel(SampleLevel());
+    LevelHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    uint64_t* walls = reinterpret_cast<uint64_t*>(bytes.data() + header.wallsOffset);
+    uint64_t* food = reinterpret_cast<uint64_t*>(bytes.data() + header.foodOffset);
+    LevelSpawn* spawns = reinterpret_cast<LevelSpawn*>(bytes.data() + header.spawnsOffset);
+    mutate(header, walls, food, spawns);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    return Loads(bytes);
+}
+
+static void SetBit(uint64_t* bits, int cell) { bits[cell >> 6] |= uint64_t(1) << (cell & 63); }
+
+int main()
+{
+    const LevelData sample = SampleLevel();
+    Check(Loads(EncodeLevel(sample)), "合法关卡可以加载");
+
+    //文件头和各段范围（原有的校验）
+    Check(!LoadsAfter([](LevelHeader& h, uint64_t*, uint64_t*, LevelSpawn*) { h.magic[0] = 'X'; }), "魔数错误被拒绝");
+    Check(!LoadsAfter([](LevelHeader& h, uint64_t*, uint64_t*, LevelSpawn*) { h.words++; }), "位图字数与尺寸不符被拒绝");
+    Check(!LoadsAfter([](LevelHeader& h, uint64_t*, uint64_t*, LevelSpawn*) { h.foodOffset = h.fileSize; }), "位图越过文件末尾被拒绝");
+    Check(!LoadsAfter([](LevelHeader&, uint64_t*, uint64_t*, LevelSpawn* s) { s[0].x = 16; }), "出生点在棋盘外被拒绝");
+    {
+        std::vector<uint8_t> bytes = EncodeLevel(sample);
+        bytes.resize(bytes.size() - 8);
+        Check(!Loads(bytes), "截断的文件被拒绝");
+    }
+
+    //食物位图与墙重叠
+    Check(!LoadsAfter([](LevelHeader& h, uint64_t*, uint64_t* food, LevelSpawn*) { SetBit(food, 3 * h.width + 5); }),
+        "可生成食物的格子是墙时被拒绝");
+    //位图中棋盘以外的位
+    //位图中棋盘以外的位：16x8正好两个字没有多余的位，这里改为检查17列的关卡
+    {
+        LevelData level(17, 8);
+        level.AddSpawn(8, 3, Direction::RIGHT);
+        std::vector<uint8_t> bytes = EncodeLevel(level);
+        Check(Loads(bytes), "17x8的空关卡可以加载");
+        LevelHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        SetBit(reinterpret_cast<uint64_t*>(bytes.data() + header.foodOffset), 17 * 8 + 3);
+        Check(!Loads(bytes), "食物位图中棋盘以外的位被拒绝");
+    }
+    //出生点的蛇头、蛇身在墙上
+    Check(!LoadsAfter([](LevelHeader&, uint64_t*, uint64_t*, LevelSpawn* s) { s[0].x = 5; }), "蛇头在墙上时被拒绝");
+    Check(!LoadsAfter([](LevelHeader&, uint64_t*, uint64_t*, LevelSpawn* s) { s[0].x = 6; }), "开局蛇身压在墙上时被拒绝");
+    Check(!LoadsAfter([](LevelHeader& h, uint64_t* walls, uint64_t* food, LevelSpawn*)
+        {
+            const int cell = 3 * h.width + 7;
+            SetBit(walls, cell);
+            food[cell >> 6] &= ~(uint64_t(1) << (cell & 63));
+        }), "蛇身后方第一格改成墙时被拒绝");
+    Check(LoadsAfter([](LevelHeader&, uint64_t*, uint64_t*, LevelSpawn* s) { s[0].x = 6; s[0].dir = static_cast<uint8_t>(Direction::LEFT); }),
+        "蛇尾贴着墙、蛇身不压墙时可以加载");
+    Check(LoadsAfter([](LevelHeader&, uint64_t*, uint64_t*, LevelSpawn* s) { s[0].x = 0; s[0].dir = static_cast<uint8_t>(Direction::RIGHT); }),
+        "蛇身被棋盘边缘截短时可以加载");
+
+    //程序生成的关卡都能通过校验
+    LevelGenerator generator;
+    int generated = 0;
+    for (uint64_t seed = 1; seed <= 50; seed++)
+    {
+        LevelData level;
+        if (generator.Generate(seed, level) >= 0 && Loads(EncodeLevel(level)))
+            generated++;
+    }
+    Check(generated == 50, "50个程序生成的关卡都能加载");
+
+    //开局长度大于默认长度时，蛇身在墙前截短，开局不会判负
+    {
+        LevelData level(GRID_WIDTH, GRID_HEIGHT);
+        level.SetWall(10, 3, true);
+        for (int y = 0; y < level.height; y++)
+        {
+            for (int x = 0; x < level.width; x++)
+            {
+                if (!level.IsWall(x, y))
+                    level.SetFood(x, y, true);
+            }
+        }
+        level.AddSpawn(15, 3, Direction::RIGHT);
+        auto map = std::make_shared<LevelMap>();
+        Check(map->Adopt(EncodeLevel(level)), "出生点前方留空的标准关卡可以加载");
+        GameRules rules;
+        rules.initialLength = 10;
+        GameCore core(1, StandardBoard(), rules);
+        core.SetLevel(map);
+        core.Reset(1);
+        InputQueue input;
+        core.Step(input);
+        Check(core.GetSnake().getsize() == 5 && !core.IsGameOver(), "开局长度10的蛇身在墙前截短为5节");
+    }
+
+    std::cout << (failures == 0 ? "全部通过" : "有测试失败") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+﻿// LevelConvert.cpp - 把文本关卡转换为二进制关卡文件(.lvl)，或按种子程序生成关卡
+// 在仓库根目录编译：
+//   g++ -O2 -std=c++17 -pthread -I. tools/LevelConvert.cpp LevelFile.cpp LevelGen.cpp ParallelFor.cpp
+// 文本格式：'#'墙，'.'可生成食物的空地，','不生成食物的空地，'^' 'v' '<' '>'出生点及朝向，
+//           "name: xxx"一行给出关卡名，"//"开头的行是注释
+// 用法：LevelConvert maze.txt maze.lvl
+//       LevelConvert --generate=20261018 daily.lvl
+#include "LevelFile.h"
+#include "LevelGen.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "用法: LevelConvert <文本关卡> <输出.lvl>\n"
+            << "      LevelConvert --generate=<种子> <输出.lvl>" << std::endl;
+        return 1;
+    }
+
+    LevelData level;
+    const std::string source = argv[1];
+    if (source.compare(0, 11, "--generate=") == 0)
+    {
+        uint64_t seed = 0;
+        try
+        {
+            seed = std::stoull(source.substr(11));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "种子格式错误: " << source << std::endl;
+            return 1;
+        }
+        ParallelFor workers(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+        if (LevelGenerator().Generate(seed, level, workers) < 0)
+        {
+            std::cerr << "种子" << seed << "没有生成合格的关卡" << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::ifstream in(argv[1]);
+        if (!in)
+        {
+            std::cerr << "无法打开: " << argv[1] << std::endl;
+            return 1;
+        }
+        std::string error;
+        if (!ParseLevelText(in, level, error))
+        {
+            std::cerr << argv[1] << ": " << error << std::endl;
+            return 1;
+        }
+    }
+
+    const std::vector<uint8_t> bytes = EncodeLevel(level);
+    std::ofstream out(argv[2], std::ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    out.close();
+    if (!out)
+    {
+        std::cerr << "写入失败: " << argv[2] << std::endl;
+        return 1;
+    }
+
+    //写出后按游戏的方式重新映射一遍，确认文件可用
+    LevelMap map;
+    if (!map.Open(argv[2]))
+    {
+        std::cerr << "生成的文件无法加载: " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cout << map.View().Name() << ": " << map.View().Width() << "x" << map.View().Height()
+        << ", " << map.View().SpawnCount() << "个出生点, " << bytes.size() << "字节" << std::endl;
+    return 0;
+}
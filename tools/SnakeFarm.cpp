@@ -0,0 +1,171 @@
+﻿// SnakeFarm.cpp - 对局农场命令行：在所有核心上跑大量无界面对局，输出JSON统计，可选写入game_records
+// 在仓库根目录编译：
+//   g++ -O2 -std=c++17 -pthread -I. tools/SnakeFarm.cpp GameFarm.cpp WorkStealing.cpp GameCore.cpp snake.cpp LevelFile.cpp LevelGen.cpp ParallelFor.cpp AdvancedSQLiteDB.cpp -lsqlite3
+// 指定--db时规则取自该数据库的system_config，否则使用默认规则
+// 用法：SnakeFarm [--games=N] [--threads=T] [--policy=random|script|bot|safe] [--script=RRDDLLUU]
+//                 [--seed=S] [--max-ticks=M] [--batch=B] [--level=maze.lvl|--level-seed=S] [--out=stats.json] [--db=snake_game.db] [--player=farm]
+#include "GameFarm.h"
+#include "AdvancedSQLiteDB.h"
+#include "LevelGen.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static void PrintUsage()
+{
+    std::cerr << "用法: SnakeFarm [--games=N] [--threads=T] [--policy=random|script|bot|safe] [--script=RRDDLLUU]\n"
+        << "                 [--seed=S] [--max-ticks=M] [--batch=B] [--level=maze.lvl|--level-seed=S] [--out=stats.json] [--db=snake_game.db] [--player=farm]"
+        << std::endl;
+}
+
+//对局使用数据库system_config中的规则，与桌面版一致
+static bool LoadRules(const std::string& path, GameRules& rules)
+{
+    AdvancedSQLiteDB db(path);
+    if (!db.open() || !db.initialize())
+        return false;
+    db.loadGameRules(rules);
+    return true;
+}
+
+//把对局结果写入game_records；时长按逻辑帧周期换算成秒
+static bool WriteRecords(const std::string& path, const std::string& player, const GameRules& rules, const FarmResult& result)
+{
+    AdvancedSQLiteDB db(path);
+    if (!db.open() || !db.initialize())
+        return false;
+
+    int playerId = 0;
+    if (!db.findPlayer(player, playerId) && !db.createPlayer(player, playerId))
+        return false;
+
+    std::vector<GameRecordRow> rows;
+    rows.reserve(result.records.size());
+    for (const FarmRecord& r : result.records)
+    {
+        rows.push_back({ r.score, r.length, r.food, r.bigFood,
+            static_cast<int>(static_cast<long long>(r.ticks) * rules.tickPeriod / 1000),
+            r.cause == DEATH_TIMEOUT || r.cause == DEATH_BOARD_FULL ? "COMPLETED" : "FAILED" });
+    }
+    return db.insertGameRecords(playerId, rows);
+}
+
+int main(int argc, char* argv[])
+{
+    FarmConfig config;
+    std::string outPath;
+    std::string dbPath;
+    std::string player = "farm";
+    std::string levelPath;
+    std::string levelSeed;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        try
+        {
+            if (key == "--games")
+                config.games = std::stoll(value);
+            else if (key == "--threads")
+                config.threads = std::stoi(value);
+            else if (key == "--policy")
+            {
+                if (!ParsePolicy(value, config.policy))
+                {
+                    std::cerr << "未知的策略: " << value << std::endl;
+                    return 1;
+                }
+            }
+            else if (key == "--script")
+                config.script = value;
+            else if (key == "--seed")
+                config.seed = std::stoull(value);
+            else if (key == "--max-ticks")
+                config.maxTicks = std::stoi(value);
+            else if (key == "--batch")
+                config.batch = std::stoi(value);
+            else if (key == "--level")
+                levelPath = value;
+            else if (key == "--level-seed")
+                levelSeed = std::to_string(std::stoull(value));
+            else if (key == "--out")
+                outPath = value;
+            else if (key == "--db")
+                dbPath = value;
+            else if (key == "--player")
+                player = value;
+            else
+            {
+                PrintUsage();
+                return key == "--help" ? 0 : 1;
+            }
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "参数格式错误: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (!levelPath.empty())
+    {
+        auto level = std::make_shared<LevelMap>();
+        if (!level->Open(levelPath))
+        {
+            std::cerr << "无法加载关卡: " << levelPath << std::endl;
+            return 1;
+        }
+        if (level->View().Width() != GRID_WIDTH || level->View().Height() != GRID_HEIGHT)
+        {
+            std::cerr << "关卡尺寸必须是" << GRID_WIDTH << "x" << GRID_HEIGHT << ": " << levelPath << std::endl;
+            return 1;
+        }
+        config.level = level;
+    }
+    else if (!levelSeed.empty())
+    {
+        //与每日挑战相同：按种子程序生成关卡，直接在内存中加载
+        LevelData data;
+        const int index = LevelGenerator().Generate(std::stoull(levelSeed), data);
+        auto level = std::make_shared<LevelMap>();
+        if (index < 0 || !level->Adopt(EncodeLevel(data)))
+        {
+            std::cerr << "无法为种子" << levelSeed << "生成关卡" << std::endl;
+            return 1;
+        }
+        config.level = level;
+    }
+
+    config.keepRecords = !dbPath.empty();
+    if (!dbPath.empty() && !LoadRules(dbPath, config.rules))
+    {
+        std::cerr << "无法打开数据库: " << dbPath << std::endl;
+        return 1;
+    }
+    const FarmResult result = RunFarm(config);
+
+    if (outPath.empty())
+    {
+        WriteFarmJson(std::cout, config, result);
+    }
+    else
+    {
+        std::ofstream out(outPath);
+        if (!out)
+        {
+            std::cerr << "无法写入: " << outPath << std::endl;
+            return 1;
+        }
+        WriteFarmJson(out, config, result);
+    }
+
+    if (!dbPath.empty() && !WriteRecords(dbPath, player, config.rules, result))
+    {
+        std::cerr << "写入数据库失败: " << dbPath << std::endl;
+        return 1;
+    }
+    return 0;
+}